@@ -0,0 +1,183 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <llvm/Support/raw_ostream.h>
+#include <ionshared/misc/helpers.h>
+#include <ionir/construct/construct.h>
+#include <ionir/const/const.h>
+#include <ionlang/construct/construct.h>
+#include <ionlang/const/const.h>
+
+namespace ilc {
+    /**
+     * Describes how to inspect the constructs of a particular AST.
+     * Specialized below for both ionlang and IonIR.
+     */
+    template<typename TConstruct>
+    struct AstTraceTraits;
+
+    template<>
+    struct AstTraceTraits<ionlang::Construct> {
+        static ionlang::Ast findChildren(const ionshared::Ptr<ionlang::Construct> &node) {
+            return node->getChildrenNodes();
+        }
+
+        static std::string findKindName(const ionshared::Ptr<ionlang::Construct> &node) {
+            return ionlang::Const::getConstructKindName(node->constructKind)
+                .value_or("Unknown (" + std::to_string((int)node->constructKind) + ")");
+        }
+    };
+
+    template<>
+    struct AstTraceTraits<ionir::Construct> {
+        static ionir::Ast findChildren(const ionshared::Ptr<ionir::Construct> &node) {
+            return node->getChildrenNodes();
+        }
+
+        static std::string findKindName(const ionshared::Ptr<ionir::Construct> &node) {
+            return ionir::Const::getConstructKindName(node->constructKind)
+                .value_or("Unknown (" + std::to_string((int)node->constructKind) + ")");
+        }
+    };
+
+    struct AstTraceStatistics {
+        size_t nodeCount = 0;
+
+        size_t maxDepth = 0;
+
+        std::map<std::string, size_t> nodeCountsByKind = {};
+
+        /**
+         * Approximate memory held by each top-level subtree, in bytes
+         * and in source order. Counts the construct objects themselves
+         * and the handles to their children, but not any heap memory
+         * owned by individual constructs (such as names).
+         */
+        std::vector<std::pair<std::string, size_t>> subtreeSizes = {};
+
+        /**
+         * Print node counts per kind, from most to least frequent,
+         * followed by the largest top-level subtrees.
+         */
+        void print(llvm::raw_ostream &output) const;
+    };
+
+    /**
+     * Walks an AST depth-first using an explicit stack, so that deeply
+     * nested inputs cannot overflow the call stack, optionally streaming
+     * one line per construct while collecting statistics.
+     */
+    template<typename TConstruct>
+    class AstTracer {
+    private:
+        typedef AstTraceTraits<TConstruct> Traits;
+
+        struct Frame {
+            ionshared::Ptr<TConstruct> node;
+
+            size_t depth;
+
+            std::vector<ionshared::Ptr<TConstruct>> children;
+
+            size_t nextChildIndex = 0;
+
+            size_t subtreeSize = 0;
+        };
+
+        llvm::raw_ostream &output;
+
+        bool dumpNodes;
+
+        static size_t estimateSize(const Frame &frame) {
+            return sizeof(TConstruct) + frame.children.size() * sizeof(ionshared::Ptr<TConstruct>);
+        }
+
+    public:
+        AstTracer(llvm::raw_ostream &output, bool dumpNodes) :
+            output(output),
+            dumpNodes(dumpNodes) {
+            //
+        }
+
+        AstTraceStatistics trace(const ionshared::Ptr<TConstruct> &root) {
+            AstTraceStatistics result = AstTraceStatistics();
+            std::vector<Frame> stack = {};
+
+            // Constructs on the path from the root, to detect cycles.
+            std::unordered_set<const TConstruct *> path = {};
+
+            auto enter = [&](const ionshared::Ptr<TConstruct> &node, size_t depth) {
+                std::string kindName = Traits::findKindName(node);
+
+                if (this->dumpNodes) {
+                    this->output.indent(depth * 2) << kindName << '\n';
+                }
+
+                result.nodeCount++;
+                result.nodeCountsByKind[kindName]++;
+                result.maxDepth = std::max(result.maxDepth, depth);
+                path.insert(node.get());
+
+                Frame frame = Frame{node, depth, Traits::findChildren(node)};
+
+                frame.subtreeSize = AstTracer::estimateSize(frame);
+                stack.push_back(std::move(frame));
+            };
+
+            if (root == nullptr) {
+                return result;
+            }
+
+            enter(root, 0);
+
+            while (!stack.empty()) {
+                Frame &frame = stack.back();
+
+                if (frame.nextChildIndex < frame.children.size()) {
+                    // Copied, since entering the child may reallocate the stack.
+                    ionshared::Ptr<TConstruct> child = frame.children[frame.nextChildIndex++];
+                    size_t childDepth = frame.depth + 1;
+
+                    if (child == nullptr) {
+                        continue;
+                    }
+                    else if (path.contains(child.get())) {
+                        if (this->dumpNodes) {
+                            this->output.indent(childDepth * 2) << "(cycle)\n";
+                        }
+
+                        continue;
+                    }
+
+                    enter(child, childDepth);
+
+                    continue;
+                }
+
+                Frame finishedFrame = std::move(frame);
+
+                stack.pop_back();
+                path.erase(finishedFrame.node.get());
+
+                if (stack.empty()) {
+                    break;
+                }
+
+                stack.back().subtreeSize += finishedFrame.subtreeSize;
+
+                if (finishedFrame.depth == 1) {
+                    result.subtreeSizes.emplace_back(
+                        Traits::findKindName(finishedFrame.node) + " #" + std::to_string(result.subtreeSizes.size()),
+                        finishedFrame.subtreeSize
+                    );
+                }
+            }
+
+            return result;
+        }
+    };
+}
@@ -6,4 +6,8 @@ namespace ilc::cli {
     static CLI::App *jitCommand;
 
     static CLI::App *traceCommand;
+
+    static CLI::App *checkCommand;
+
+    static CLI::App *versionCommand;
 }
@@ -67,8 +67,20 @@ namespace ilc {
 
         static std::string apply(std::string text, ColorKind color);
 
+        /**
+         * Apply the color only if enabled, rather than according to the
+         * command-line options.
+         */
+        static std::string apply(std::string text, ColorKind color, bool enabled);
+
         static std::string coat(std::string text, ColorKind color);
 
+        /**
+         * Coat the text only if enabled, rather than according to the
+         * command-line options.
+         */
+        static std::string coat(std::string text, ColorKind color, bool enabled);
+
         static std::string red(std::string text);
 
         static std::string green(std::string text);
@@ -11,6 +11,12 @@ namespace ilc::cli {
 
         Parsing,
 
+        /**
+         * Lowering into IonIR, along with all semantic and analysis
+         * passes.
+         */
+        Semantic,
+
         CodeGeneration
     };
 
@@ -28,11 +34,72 @@ namespace ilc::cli {
         BorrowCheck
     };
 
+    enum class OptimizationLevel {
+        O0,
+
+        O1,
+
+        O2,
+
+        O3,
+
+        Os,
+
+        Oz
+    };
+
+    enum class LtoKind {
+        None,
+
+        Thin,
+
+        Full
+    };
+
+    enum class EmitKind {
+        /**
+         * One object file per input, written to the output directory.
+         * Holds LLVM bitcode instead when using link-time optimization.
+         */
+        Object,
+
+        Executable,
+
+        SharedObject,
+
+        /**
+         * A static archive of the objects of every input, written without
+         * writing the objects on their own.
+         */
+        Archive,
+
+        /**
+         * Assembly, LLVM IR and LLVM bitcode of each input's optimized
+         * module, written next to its object file. All are produced from
+         * the same optimized module as the object code.
+         */
+        Assembly,
+
+        LlvmIr,
+
+        LlvmBitcode
+    };
+
     struct Options {
         std::vector<std::string> inputFilePaths = std::vector<std::string>();
 
+        /**
+         * The last phase to run. Any phase before code generation only
+         * reports diagnostics, writing no output.
+         */
         PhaseLevel phaseLevel = PhaseLevel::CodeGeneration;
 
+        /**
+         * Whether to omit the intermediate output of each phase, only
+         * reporting diagnostics.
+         */
+        bool diagnosticsOnly = false;
+
         std::set<PassKind> passes;
 
         /**
@@ -40,21 +107,230 @@ namespace ilc::cli {
          */
         std::string out = "build";
 
+        /**
+         * Target triple to generate code for. Defaults to the host's.
+         */
+        std::optional<std::string> target = std::nullopt;
+
+        /**
+         * Files whose interfaces are prepended to every input, and whose
+         * definitions are compiled into objects of their own.
+         */
+        std::vector<std::string> preludeFilePaths = std::vector<std::string>();
+
+        /**
+         * Directories searched, besides the output directory, for the
+         * interface files of imported modules which are not among the
+         * inputs.
+         */
+        std::vector<std::string> modulePaths = std::vector<std::string>();
+
+        /**
+         * When set, a snapshot is created at this path, and no input is
+         * processed.
+         */
+        std::optional<std::string> snapshotCreatePath = std::nullopt;
+
+        /**
+         * Snapshot to load instead of querying the host and reading the
+         * prelude.
+         */
+        std::optional<std::string> snapshotPath = std::nullopt;
+
+        /**
+         * Maximum amount of input files to compile in parallel. A
+         * value of zero means one per available hardware thread.
+         */
+        uint32_t jobs = 0;
+
+        /**
+         * Whether to skip writing a depfile next to each output.
+         */
+        bool noDepfile = false;
+
+        /**
+         * Whether to skip caching the lowered module of each input next
+         * to its output, and always run the frontend.
+         */
+        bool noAstCache = false;
+
+        OptimizationLevel optimizationLevel = OptimizationLevel::O0;
+
+        /**
+         * Whether to generate machine code as fast as possible, regardless
+         * of the optimization level: without code generation optimizations,
+         * through the target's fast instruction selector, and with the
+         * fast register allocator. The LLVM IR is still optimized.
+         */
+        bool fastCodegen = false;
+
+        /**
+         * When set, each input file is emitted as LLVM bitcode, and
+         * a link-time step optimizes across all of them.
+         */
+        LtoKind lto = LtoKind::None;
+
+        /**
+         * Directory in which ThinLTO backend results are cached across
+         * runs. Defaults to a directory inside the output directory.
+         */
+        std::optional<std::string> ltoCacheDirectory = std::nullopt;
+
+        /**
+         * Whether the link-time step may internalize every symbol except
+         * the entry point. Only safe when no other object references the
+         * resulting objects.
+         */
+        bool ltoInternalize = false;
+
+        /**
+         * File which to write LLVM optimization remarks to, either as
+         * YAML or, given a '.bitstream' extension, as LLVM bitstream.
+         * When compiling several inputs, each gets its own file named
+         * after it.
+         */
+        std::optional<std::string> remarksOutput = std::nullopt;
+
+        /**
+         * Regular expression selecting the passes whose remarks to keep.
+         */
+        std::optional<std::string> remarksFilter = std::nullopt;
+
+        /**
+         * Whether to emit object code one function at a time, reusing
+         * the code of unchanged functions from previous runs. Only code
+         * generation is incremental; every input is still lexed, parsed
+         * and checked as a whole.
+         */
+        bool incremental = false;
+
+        /**
+         * Directory in which per-function object code is cached across
+         * runs. Defaults to a directory next to the output files.
+         */
+        std::optional<std::string> incrementalCacheDirectory = std::nullopt;
+
+        std::set<EmitKind> emit = {EmitKind::Object};
+
+        /**
+         * Whether the linker should remove unreferenced sections. Every
+         * function and global is then emitted into its own section, so
+         * that those unreachable from the entry point and exported
+         * symbols are removed.
+         */
+        bool gcSections = false;
+
+        /**
+         * Whether the linker should fold identical code.
+         */
+        bool icf = false;
+
+        /**
+         * Whether to skip linking the C runtime start files and libraries.
+         */
+        bool noDefaultLibraries = false;
+
+        std::vector<std::string> linkerArguments = std::vector<std::string>();
+
+        /**
+         * Names of the functions to compile once per multiversioning
+         * target, dispatching between them at load time. The rest of the
+         * code then targets the architecture's baseline, rather than the
+         * build host's CPU.
+         */
+        std::vector<std::string> multiversionFunctions = std::vector<std::string>();
+
+        std::vector<std::string> multiversionTargets = {"x86-64-v2", "x86-64-v3", "x86-64-v4"};
+
+        /**
+         * Whether to instrument code to count how often its branches and
+         * calls are taken at run time. Instrumented programs write a raw
+         * profile upon exit, to 'default.profraw' unless LLVM_PROFILE_FILE
+         * is set.
+         */
+        bool profileGenerate = false;
+
+        /**
+         * Path of an indexed profile, as merged by 'llvm-profdata' from
+         * the raw profiles of an instrumented build, to guide optimization
+         * with.
+         */
+        std::optional<std::string> profileUse = std::nullopt;
+
+        /**
+         * Path of the profile runtime archive to link instrumented
+         * programs with, overriding the one found amongst the installed
+         * Clang resource directories.
+         */
+        std::optional<std::string> profileRuntime = std::nullopt;
+
+        /**
+         * Whether the trace command should only print statistics.
+         */
+        bool traceSummaryOnly = false;
+
+        /**
+         * Whether to print compile statistics upon exit.
+         */
+        bool stats = false;
+
+        /**
+         * Whether compile statistics should be printed as JSON instead
+         * of a table. Implies 'stats'.
+         */
+        bool statsJson = false;
+
+        /**
+         * Whether to print hardware performance counters of each phase
+         * upon exit.
+         */
+        bool perfCounters = false;
+
+        /**
+         * Whether to print the compile time spent on each of the slowest
+         * functions upon exit.
+         */
+        bool functionTimeReport = false;
+
+        /**
+         * Amount of functions listed by the function time report.
+         */
+        uint32_t functionTimeReportLimit = 10;
+
+        /**
+         * Whether to print the machine code size, stack frame size and
+         * inlined callees of every emitted function upon exit.
+         */
+        bool sizeReport = false;
+
+        /**
+         * Whether the size report should be printed as JSON instead of
+         * a table. Implies 'sizeReport'.
+         */
+        bool sizeReportJson = false;
+
         /**
          * Whether to throw exceptions caught within
          * REPL mode.
          */
-        bool jitThrow;
+        bool jitThrow = false;
 
-        bool noColor;
+        bool noColor = false;
 
         /**
-         * Whether to emit LLVM IR instead of LLVM bitcode.
+         * Whether to also emit LLVM IR. Equivalent to requesting
+         * EmitKind::LlvmIr.
          */
-        bool llvmIr;
+        bool llvmIr = false;
 
-        bool debug;
+        bool debug = false;
     };
 
-    static Options options = Options{};
+    /**
+     * Options parsed by the command-line. The library receives its
+     * options explicitly through a compilation session; only features
+     * exclusive to the command-line, such as the REPL and console output,
+     * read these directly.
+     */
+    inline Options options = Options{};
 }
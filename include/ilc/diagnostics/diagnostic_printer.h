@@ -49,10 +49,6 @@ namespace ilc {
             bool colors = true
         );
 
-        [[nodiscard]] static std::string findDiagnosticTypeText(
-            ionshared::DiagnosticType type
-        );
-
         [[nodiscard]] static std::string resolveInputText(
             const std::string &input,
             std::vector<ionlang::Token> lineBuffer
@@ -95,6 +91,10 @@ namespace ilc {
         );
 
     public:
+        [[nodiscard]] static std::string findDiagnosticTypeText(
+            ionshared::DiagnosticType type
+        );
+
         explicit DiagnosticPrinter(DiagnosticPrinterOpts opts);
 
         DiagnosticPrinterResult createDiagnosticStackTrace(
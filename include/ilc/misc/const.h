@@ -1,5 +1,11 @@
 #pragma once
 
+/**
+ * Version of ilc. Also part of the keys of on-disk caches, since another
+ * version may lower the same input differently.
+ */
+#define ILC_CLI_VERSION "1.0.0"
+
 #include <string>
 
 namespace ilc {
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <functional>
+#include <llvm/Support/raw_ostream.h>
+
+namespace ilc {
+    /**
+     * Prints a report to the given stream.
+     */
+    typedef std::function<void(llvm::raw_ostream &output)> ExitReportPrinter;
+
+    /**
+     * Prints process-wide reports, such as statistics, to the standard
+     * error stream upon exit, in order of registration.
+     */
+    class ExitReport {
+    public:
+        /**
+         * Register a printer to be invoked upon exit. Any state the
+         * printer reads must be constructed beforehand, so that it is
+         * destroyed after the report is printed.
+         */
+        static void registerPrinter(ExitReportPrinter printer);
+    };
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/OptBisect.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace ilc {
+    /**
+     * Compile time attributed to each function, per phase. Functions
+     * are identified by name only, so same-named functions of different
+     * inputs are reported as one. Does nothing unless enabled.
+     */
+    class FunctionTimeReport {
+    public:
+        /**
+         * Enable timing, and print the given amount of slowest functions
+         * to the standard error stream upon exit.
+         */
+        static void enable(uint32_t limit);
+
+        static bool isEnabled() noexcept;
+
+        static void add(
+            const std::string &functionName,
+            const std::string &phaseName,
+            std::chrono::steady_clock::duration duration
+        );
+
+        /**
+         * Record the amount of LLVM IR instructions of a function, as
+         * lowered and before optimization.
+         */
+        static void setInstructionCount(const std::string &functionName, uint64_t count);
+
+        static void print(llvm::raw_ostream &output);
+    };
+
+    /**
+     * Attributes the time from its construction until its destruction
+     * to a function. Does nothing unless the report was enabled.
+     */
+    class FunctionTimer {
+    private:
+        std::string functionName;
+
+        std::string phaseName;
+
+        std::optional<std::chrono::steady_clock::time_point> start = std::nullopt;
+
+    public:
+        FunctionTimer(std::string functionName, std::string phaseName);
+
+        FunctionTimer(const FunctionTimer &) = delete;
+
+        ~FunctionTimer();
+    };
+
+    /**
+     * Attributes the time spent by LLVM's legacy pass managers to each
+     * function while installed on a context. Passes ask the context's
+     * gate whether to run before working on a function; the time since
+     * the previous such query is attributed to the function worked on
+     * before. Passes which never ask are thereby counted towards the
+     * function preceding them. Queries are forwarded to the previously
+     * installed gate, which is restored upon destruction.
+     */
+    class FunctionTimingPassGate : public llvm::OptPassGate {
+    private:
+        llvm::LLVMContext &context;
+
+        llvm::OptPassGate &previousGate;
+
+        std::string phaseName;
+
+        std::optional<std::string> functionName = std::nullopt;
+
+        std::chrono::steady_clock::time_point start;
+
+        void switchFunction(std::optional<std::string> nextFunctionName);
+
+    public:
+        FunctionTimingPassGate(llvm::LLVMContext &context, std::string phaseName);
+
+        FunctionTimingPassGate(const FunctionTimingPassGate &) = delete;
+
+        ~FunctionTimingPassGate() override;
+
+        [[nodiscard]] bool isEnabled() const override;
+
+        bool shouldRunPass(const llvm::Pass *pass, llvm::StringRef irDescription) override;
+    };
+}
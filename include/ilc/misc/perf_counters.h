@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <llvm/Support/raw_ostream.h>
+
+namespace ilc {
+    enum class PerfCounterKind : size_t {
+        Cycles,
+
+        Instructions,
+
+        CacheMisses,
+
+        BranchMisses
+    };
+
+    /**
+     * Amount of counter kinds above.
+     */
+    constexpr size_t perfCounterKindCount = 4;
+
+    /**
+     * Counter values, each unset if the counter could not be opened or
+     * read on this system.
+     */
+    typedef std::array<std::optional<uint64_t>, perfCounterKindCount> PerfCounterValues;
+
+    /**
+     * Hardware performance counters accumulated per compiler phase,
+     * using Linux's perf_event_open(2). Counters only count the thread
+     * which opened them, so each thread keeps its own set; the work of
+     * helper threads spawned within a phase is not included in it.
+     * Phases report no values where counters are unavailable, such as
+     * within containers or on other platforms.
+     */
+    class PerfCounters {
+    public:
+        /**
+         * Enable counting, and print the counters of every phase to the
+         * standard error stream upon exit.
+         */
+        static void enable();
+
+        static bool isEnabled() noexcept;
+
+        /**
+         * Read the current values of the calling thread's counters,
+         * opening them first if needed.
+         */
+        static PerfCounterValues read();
+
+        /**
+         * Add the difference between the given start and end values to
+         * the totals of a phase.
+         */
+        static void accumulate(
+            const std::string &phaseName,
+            const PerfCounterValues &start,
+            const PerfCounterValues &end
+        );
+
+        static void print(llvm::raw_ostream &output);
+    };
+
+    /**
+     * Attributes the counters of the calling thread to a phase, from its
+     * construction until its destruction. Does nothing unless counters
+     * were enabled.
+     */
+    class PerfPhase {
+    private:
+        std::string phaseName;
+
+        std::optional<PerfCounterValues> start = std::nullopt;
+
+    public:
+        explicit PerfPhase(std::string phaseName);
+
+        PerfPhase(const PerfPhase &) = delete;
+
+        ~PerfPhase();
+    };
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <llvm/IR/DiagnosticHandler.h>
+#include <llvm/IR/DiagnosticInfo.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace ilc {
+    enum class SizeReportFormat {
+        Table,
+
+        Json
+    };
+
+    struct FunctionSize {
+        /**
+         * Name of the Ion module defining the function, as recorded in
+         * the source file name of the LLVM module lowered from it.
+         */
+        std::string moduleName;
+
+        std::string functionName;
+
+        /**
+         * Bytes of machine code. Not set when no object code was
+         * generated, such as when using link-time optimization.
+         */
+        std::optional<uint64_t> codeSize = std::nullopt;
+
+        /**
+         * Bytes of the function's stack frame, as laid out by the code
+         * generator.
+         */
+        std::optional<uint64_t> stackSize = std::nullopt;
+
+        /**
+         * Names of the functions inlined into the function, in order of
+         * first inlining.
+         */
+        std::vector<std::string> inlinedCallees = {};
+    };
+
+    /**
+     * Machine code size, stack frame size and inlined callees of every
+     * emitted function, grouped by source file and by Ion module. Does
+     * nothing unless enabled.
+     */
+    class SizeReport {
+    public:
+        /**
+         * Enable the report, and print it in the given format to the
+         * standard error stream upon exit.
+         */
+        static void enable(SizeReportFormat format);
+
+        static bool isEnabled() noexcept;
+
+        static void add(const std::string &sourceFilePath, std::vector<FunctionSize> functions);
+
+        /**
+         * Find the size of each function symbol defined by the given
+         * object file. Returns an empty map if it cannot be read.
+         */
+        static std::map<std::string, uint64_t> findCodeSizes(llvm::MemoryBufferRef objectCode);
+
+        static void print(llvm::raw_ostream &output, SizeReportFormat format);
+    };
+
+    /**
+     * Collects the stack frame sizes and inlined callees of the functions
+     * compiled within a context, from the remarks of the prologue and
+     * epilogue inserter and of the inliner, while installed upon it. Other
+     * diagnostics are forwarded to the previously installed handler, which
+     * is restored upon destruction.
+     */
+    class SizeReportCollector {
+    private:
+        llvm::LLVMContext &context;
+
+        std::unique_ptr<llvm::DiagnosticHandler> previousHandler;
+
+        std::map<std::string, uint64_t> stackSizes = {};
+
+        std::map<std::string, std::vector<std::string>> inlinedCallees = {};
+
+    public:
+        explicit SizeReportCollector(llvm::LLVMContext &context);
+
+        SizeReportCollector(const SizeReportCollector &) = delete;
+
+        ~SizeReportCollector();
+
+        [[nodiscard]] llvm::DiagnosticHandler &getPreviousHandler() const;
+
+        /**
+         * Record the remark, if relevant. Returns true if the diagnostic
+         * was handled.
+         */
+        bool handleDiagnostics(const llvm::DiagnosticInfo &diagnosticInfo);
+
+        /**
+         * Describe every function defined by the module, measuring their
+         * machine code within the given object code, if any.
+         */
+        [[nodiscard]] std::vector<FunctionSize> collect(
+            const llvm::Module &module,
+            const llvm::MemoryBuffer *objectCode
+        ) const;
+    };
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace ilc {
+    class StaticInit {
+    public:
+        /**
+         * Perform the static initialization required by the frontend,
+         * such as populating the lexer's tables. Deferred until input is
+         * first lexed, so that commands which never lex (such as --help
+         * or version) do not pay for it. Safe to invoke from multiple
+         * drivers running in parallel; only the first invocation has
+         * any effect.
+         */
+        static void ensureInitialized();
+    };
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <llvm/Support/raw_ostream.h>
+
+namespace ilc {
+    enum class StatisticsFormat {
+        Table,
+
+        Json
+    };
+
+    /**
+     * Counters known ahead of time, each counted into a fixed slot
+     * rather than looked up by name.
+     */
+    enum class Statistic {
+        LexerTokens,
+
+        IonIrFunctions,
+
+        IonIrBasicBlocks,
+
+        IonIrInstructions,
+
+        IonIrBranchesFolded,
+
+        IonIrUnreachableBlocksRemoved,
+
+        IonIrDeadInstructionsRemoved,
+
+        IonIrDeadFunctionsStripped,
+
+        LlvmIrFunctions,
+
+        LlvmIrBasicBlocks,
+
+        LlvmIrInstructions,
+
+        CodegenBytesEmitted,
+
+        IonLangLoggerVisits,
+
+        IonIrLoggerVisits,
+
+        // Must remain last.
+        Count
+    };
+
+    /**
+     * Counters describing a compilation, in the spirit of LLVM's
+     * '-stats'. Counters known ahead of time are atomic slots; other
+     * counters are named, and each thread counts those into its own
+     * table without any synchronization, merged into a global one when
+     * their thread exits, and once more when statistics are collected.
+     * Counting is a no-op unless statistics were enabled; call sites
+     * building names should check whether they are first.
+     */
+    class Statistics {
+    public:
+        /**
+         * Enable counting, and print all statistics in the given format
+         * to the standard error stream upon exit. Must be invoked before
+         * any other thread is started.
+         */
+        static void enable(StatisticsFormat format);
+
+        static bool isEnabled() noexcept;
+
+        static std::string findName(Statistic statistic);
+
+        static void add(Statistic statistic, uint64_t amount = 1);
+
+        static void add(const std::string &group, const std::string &name, uint64_t amount = 1);
+
+        /**
+         * Merge the counters of the calling thread and of every exited
+         * thread, along with LLVM's own statistics.
+         */
+        static std::map<std::string, uint64_t> collect();
+
+        static void print(llvm::raw_ostream &output, StatisticsFormat format);
+    };
+}
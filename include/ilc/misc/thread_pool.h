@@ -0,0 +1,78 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ilc {
+    typedef std::function<void()> ThreadPoolTask;
+
+    class ThreadPool {
+    private:
+        std::vector<std::thread> workers;
+
+        uint32_t nestedThreadCount;
+
+        std::queue<ThreadPoolTask> tasks;
+
+        std::mutex mutex;
+
+        std::condition_variable taskAvailable;
+
+        std::condition_variable idle;
+
+        /**
+         * The amount of tasks which are either queued or
+         * currently being executed by a worker.
+         */
+        uint32_t pendingTasks = 0;
+
+        bool stopping = false;
+
+        std::exception_ptr exception = nullptr;
+
+        void work();
+
+    public:
+        /**
+         * Resolve the amount of worker threads to use. A value of
+         * zero means one worker per available hardware thread.
+         */
+        static uint32_t resolveThreadCount(uint32_t threadCount);
+
+        /**
+         * The amount of threads which the task running on the calling
+         * thread may use in turn, such as for a nested pool. Unlimited,
+         * as represented by zero, outside of any pool's workers.
+         */
+        static uint32_t findNestedThreadCount() noexcept;
+
+        /**
+         * Create a pool whose tasks may each use the given amount of
+         * threads in turn, which by default prevents them from using any
+         * besides their own.
+         */
+        explicit ThreadPool(uint32_t threadCount = 0, uint32_t nestedThreadCount = 1);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        [[nodiscard]] uint32_t getThreadCount() const noexcept;
+
+        void submit(ThreadPoolTask task);
+
+        /**
+         * Block until every submitted task, including tasks
+         * submitted by other tasks, has finished executing. Re-throws
+         * the first exception thrown by a task, if any.
+         */
+        void wait();
+    };
+}
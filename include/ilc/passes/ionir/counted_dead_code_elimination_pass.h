@@ -0,0 +1,23 @@
+#pragma once
+
+#include <ionir/passes/optimization/dead_code_elimination_pass.h>
+
+namespace ilc {
+    /**
+     * Eliminates dead code exactly as its base does, additionally
+     * counting the instructions removed from each function.
+     */
+    struct CountedDeadCodeEliminationPass : ionir::DeadCodeEliminationPass {
+        /**
+         * Count the instructions of all basic blocks of the given
+         * function's body.
+         */
+        [[nodiscard]] static size_t findInstructionCount(const ionshared::Ptr<ionir::Function> &function);
+
+        explicit CountedDeadCodeEliminationPass(
+            ionshared::Ptr<ionshared::PassContext> context
+        );
+
+        void visitFunction(ionshared::Ptr<ionir::Function> node) override;
+    };
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <ionir/passes/pass.h>
+
+namespace ilc {
+    /**
+     * Folds branches whose condition is a boolean literal, so that both
+     * of their edges lead to the taken block. The block no longer taken
+     * is then left for unreachable block removal.
+     */
+    struct IonIrConstantFoldingPass : ionir::Pass {
+        IONSHARED_PASS_ID;
+
+        explicit IonIrConstantFoldingPass(
+            ionshared::Ptr<ionshared::PassContext> context
+        );
+
+        void visitBasicBlock(ionshared::Ptr<ionir::BasicBlock> node) override;
+    };
+}
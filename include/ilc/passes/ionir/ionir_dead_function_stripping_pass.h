@@ -0,0 +1,23 @@
+#pragma once
+
+#include <ionir/passes/pass.h>
+
+#define ILC_IONIR_ENTRY_POINT_NAME "main"
+
+namespace ilc {
+    /**
+     * Removes every function of a module which cannot be reached through
+     * calls from its entry point. Modules without an entry point are left
+     * untouched, since any of their functions may be called by another
+     * module.
+     */
+    struct IonIrDeadFunctionStrippingPass : ionir::Pass {
+        IONSHARED_PASS_ID;
+
+        explicit IonIrDeadFunctionStrippingPass(
+            ionshared::Ptr<ionshared::PassContext> context
+        );
+
+        void visitModule(ionshared::Ptr<ionir::Module> node) override;
+    };
+}
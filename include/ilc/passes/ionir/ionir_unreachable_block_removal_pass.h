@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+#include <ionir/passes/pass.h>
+
+namespace ilc {
+    /**
+     * Removes every basic block of a function which cannot be reached
+     * by following branches and jumps from its entry block.
+     */
+    struct IonIrUnreachableBlockRemovalPass : ionir::Pass {
+        IONSHARED_PASS_ID;
+
+        /**
+         * Find the blocks which the given block's branches and jumps
+         * may transfer control to.
+         */
+        [[nodiscard]] static std::vector<ionshared::Ptr<ionir::BasicBlock>> findSuccessors(
+            const ionshared::Ptr<ionir::BasicBlock> &basicBlock
+        );
+
+        explicit IonIrUnreachableBlockRemovalPass(
+            ionshared::Ptr<ionshared::PassContext> context
+        );
+
+        void visitFunction(ionshared::Ptr<ionir::Function> node) override;
+    };
+}
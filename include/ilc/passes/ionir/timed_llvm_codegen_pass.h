@@ -0,0 +1,18 @@
+#pragma once
+
+#include <ionir/passes/codegen/llvm_codegen_pass.h>
+
+namespace ilc {
+    /**
+     * Lowers to LLVM IR exactly as its base does, additionally
+     * attributing the time spent on each function to it in the function
+     * time report.
+     */
+    struct TimedLlvmCodegenPass : ionir::LlvmCodegenPass {
+        explicit TimedLlvmCodegenPass(
+            ionshared::Ptr<ionshared::PassContext> context
+        );
+
+        void visitFunction(ionshared::Ptr<ionir::Function> node) override;
+    };
+}
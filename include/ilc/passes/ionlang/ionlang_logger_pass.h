@@ -1,13 +1,22 @@
 #pragma once
 
+#include <functional>
+#include <string>
 #include <ionlang/passes/pass.h>
 
 namespace ilc {
     struct IonLangLoggerPass : ionlang::Pass {
         IONSHARED_PASS_ID;
 
+        /**
+         * Receives each logged line, in place of the standard output
+         * stream.
+         */
+        std::function<void(const std::string &text)> output;
+
         explicit IonLangLoggerPass(
-            ionshared::Ptr<ionshared::PassContext> context
+            ionshared::Ptr<ionshared::PassContext> context,
+            std::function<void(const std::string &text)> output = nullptr
         );
 
         void visit(ionshared::Ptr<ionlang::Construct> node) override;
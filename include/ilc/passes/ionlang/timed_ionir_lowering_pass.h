@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ionlang/passes/lowering/ionir_lowering_pass.h>
+
+namespace ilc {
+    /**
+     * Lowers to IonIR exactly as its base does, additionally attributing
+     * the time spent on each function to it in the function time report.
+     */
+    struct TimedIonIrLoweringPass : ionlang::IonIrLoweringPass {
+        explicit TimedIonIrLoweringPass(
+            ionshared::Ptr<ionshared::PassContext> context
+        );
+
+        void visitFunction(ionshared::Ptr<ionlang::Function> node) override;
+    };
+}
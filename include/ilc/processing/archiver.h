@@ -0,0 +1,45 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include <llvm/ADT/Triple.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+namespace ilc {
+    struct ArchiverOpts {
+        const std::filesystem::path outputFilePath;
+
+        const llvm::Triple targetTriple;
+    };
+
+    /**
+     * Writes in-memory objects straight into a static archive, including
+     * a symbol table, without writing the objects to disk on their own.
+     */
+    class Archiver {
+    private:
+        ArchiverOpts opts;
+
+    public:
+        /**
+         * Rename members which share their name with a previous member,
+         * such as objects of same-named inputs in different directories,
+         * by suffixing their stem with a number.
+         */
+        [[nodiscard]] static std::vector<std::string> findUniqueMemberNames(const std::vector<std::string> &memberNames);
+
+        explicit Archiver(ArchiverOpts opts);
+
+        /**
+         * Archive the given objects under the given member names, which
+         * must be as many as there are objects. Returns true if
+         * successful, and false otherwise.
+         */
+        bool archive(
+            const std::vector<std::unique_ptr<llvm::MemoryBuffer>> &objects,
+            const std::vector<std::string> &memberNames
+        );
+    };
+}
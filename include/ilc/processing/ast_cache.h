@@ -0,0 +1,58 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <set>
+#include <string>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <ilc/cli/options.h>
+
+namespace ilc {
+    /**
+     * Caches the result of the frontend (lexing, parsing, semantic
+     * analysis and lowering) for each input, so that unchanged inputs
+     * go straight to optimization and code generation.
+     *
+     * A cache file consists of a fixed-size header followed by the
+     * lowered module in LLVM bitcode. The header holds a magic value,
+     * the schema version, and a hash of the input's contents along
+     * with everything else affecting the frontend's result. The whole
+     * file is mapped into memory at once, and the bitcode is read from
+     * the mapping directly.
+     */
+    class AstCache {
+    public:
+        static std::filesystem::path makePath(const std::filesystem::path &outputFilePath);
+
+        static std::string findContentHash(
+            const std::string &input,
+            const llvm::Triple &targetTriple,
+            const std::set<cli::PassKind> &passes,
+            bool optimizesIonIr
+        );
+
+        /**
+         * Load the module cached at the given path into the given
+         * context. Returns nullptr if there is no cache file, or if it
+         * is stale, invalid, or of another schema version.
+         */
+        static std::unique_ptr<llvm::Module> load(
+            const std::filesystem::path &cacheFilePath,
+            const std::string &contentHash,
+            llvm::LLVMContext &context
+        );
+
+        /**
+         * Write the module to the given path, replacing any previous
+         * cache file atomically. Returns true if successful, and false
+         * otherwise.
+         */
+        static bool store(
+            const std::filesystem::path &cacheFilePath,
+            const std::string &contentHash,
+            const llvm::Module &module
+        );
+    };
+}
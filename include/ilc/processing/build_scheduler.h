@@ -0,0 +1,40 @@
+#pragma once
+
+#include <functional>
+#include <ilc/processing/dependency_graph.h>
+
+namespace ilc {
+    /**
+     * A build task for a single node of the dependency graph. Returns
+     * true if successful, and false otherwise.
+     */
+    typedef std::function<bool(size_t index)> BuildTask;
+
+    /**
+     * Executes a build task for every node of a dependency graph in
+     * topological order. A node is scheduled as soon as all of its
+     * dependencies have completed, rather than level-by-level, which
+     * allows for maximum parallelism. Nodes whose dependencies failed
+     * are skipped.
+     */
+    class BuildScheduler {
+    private:
+        const DependencyGraph &graph;
+
+        uint32_t jobs;
+
+    public:
+        /**
+         * A jobs value of zero means one job per available hardware
+         * thread.
+         */
+        explicit BuildScheduler(const DependencyGraph &graph, uint32_t jobs = 0);
+
+        /**
+         * Run the given task for every node. Returns true if every task
+         * succeeded, and false if any task failed, was skipped, or if
+         * the graph contains a cycle.
+         */
+        bool run(const BuildTask &task);
+    };
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include <llvm/Support/MemoryBuffer.h>
+#include <ilc/cli/options.h>
+#include <ilc/processing/compilation_session.h>
+
+namespace ilc {
+    /**
+     * Builds a set of input files as a whole, the way the command-line
+     * utility does: inputs are compiled through a single compilation
+     * session in the order of their module dependencies, each seeing the
+     * prelude and the interfaces of the modules it imports, along with
+     * module interfaces, depfiles and the prelude's own objects. The
+     * resulting objects may then go through the link-time step, and be
+     * linked or archived into the requested artifact.
+     */
+    class BuildSession {
+    private:
+        cli::Options options;
+
+        DiagnosticSink diagnosticSink;
+
+        std::mutex outputMutex;
+
+        static bool writeObjectFile(const std::filesystem::path &objectFilePath, const llvm::MemoryBuffer &object);
+
+        /**
+         * Pass the output buffered by the compilation which last ran on
+         * the current thread to the diagnostic sink, or print it to the
+         * standard output stream if none was given.
+         */
+        void flushOutput();
+
+        std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> runLinkTimeOptimization(
+            CompilationSession &session,
+            const std::filesystem::path &outputDirectoryPath,
+            std::vector<std::unique_ptr<llvm::MemoryBuffer>> bitcodeBuffers
+        );
+
+    public:
+        /**
+         * Output of concurrent compilations is buffered, and only passed
+         * to the given diagnostic sink once each compilation completes,
+         * so that it is never interleaved.
+         */
+        explicit BuildSession(cli::Options options, DiagnosticSink diagnosticSink = nullptr);
+
+        [[nodiscard]] const cli::Options &getOptions() const noexcept;
+
+        /**
+         * Build the input files named by the options. Returns true if
+         * successful, and false otherwise.
+         */
+        bool run();
+    };
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#define ILC_COMPILATION_SESSION_DEFAULT_OBJECT_CACHE_CAPACITY (64 * 1024 * 1024)
+
+#include <filesystem>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include <llvm/ADT/Triple.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <ilc/cli/options.h>
+#include <ilc/processing/driver.h>
+#include <ilc/processing/remarks.h>
+
+namespace ilc {
+    struct CompilationInput {
+        /**
+         * Identifies the input, such as its file path. Also used to tell
+         * Ion sources apart from LLVM inputs by extension.
+         */
+        std::string name;
+
+        std::string contents;
+
+        /**
+         * When set, the output is also written to this path if object
+         * emission was requested, and caches kept on disk next to it are
+         * used. Otherwise, compilation happens entirely in memory.
+         */
+        std::optional<std::filesystem::path> outputFilePath = std::nullopt;
+
+        std::optional<RemarksOpts> remarksOpts = std::nullopt;
+    };
+
+    /**
+     * The entry point for embedding ilc. A session owns its options,
+     * diagnostic sink, target configuration and caches, and compiles
+     * in-memory inputs into in-memory objects (or, when using link-time
+     * optimization, bitcode). Several sessions may compile concurrently,
+     * and a single session may compile several inputs concurrently.
+     * Sessions do share process-wide state: logging, the statistics,
+     * performance counter, function time and size reports, and the
+     * active snapshot.
+     */
+    class CompilationSession {
+    private:
+        cli::Options options;
+
+        DiagnosticSink diagnosticSink;
+
+        llvm::Triple targetTriple;
+
+        std::mutex objectCacheMutex;
+
+        /**
+         * Maximum amount of bytes of output kept by the object cache.
+         */
+        size_t objectCacheCapacity;
+
+        size_t objectCacheSize = 0;
+
+        /**
+         * Outputs of in-memory compilations, keyed by a hash of their
+         * input and of every option affecting them, from most to least
+         * recently used.
+         */
+        std::list<std::pair<std::string, std::string>> objectCache = {};
+
+        std::map<std::string, std::list<std::pair<std::string, std::string>>::iterator> objectCacheEntries = {};
+
+        /**
+         * Find the cached output of the given key, marking it as the most
+         * recently used. Must be called while holding the object cache
+         * mutex.
+         */
+        [[nodiscard]] std::optional<std::string> findCachedObject(const std::string &key);
+
+        /**
+         * Cache the output under the given key, evicting the least recently
+         * used outputs in excess of the capacity. Must be called while
+         * holding the object cache mutex.
+         */
+        void cacheObject(const std::string &key, std::string object);
+
+        [[nodiscard]] std::string findObjectCacheKey(const CompilationInput &input) const;
+
+    public:
+        /**
+         * Resolve the target triple of the given options: the requested
+         * one, or the host's (as recorded by the active snapshot, if any).
+         */
+        static llvm::Triple findTargetTriple(const cli::Options &options);
+
+        /**
+         * Create a session. Outputs of in-memory compilations are cached
+         * up to the given amount of bytes; a capacity of zero disables the
+         * cache.
+         */
+        explicit CompilationSession(
+            cli::Options options,
+            DiagnosticSink diagnosticSink = nullptr,
+            size_t objectCacheCapacity = ILC_COMPILATION_SESSION_DEFAULT_OBJECT_CACHE_CAPACITY
+        );
+
+        [[nodiscard]] const cli::Options &getOptions() const noexcept;
+
+        [[nodiscard]] const llvm::Triple &getTargetTriple() const noexcept;
+
+        /**
+         * Compile a single input. Returns the resulting output, which is
+         * nullptr when the phase level stops before code generation, or
+         * std::nullopt upon failure.
+         */
+        std::optional<std::unique_ptr<llvm::MemoryBuffer>> compile(const CompilationInput &input);
+
+        /**
+         * Run the link-time step over the bitcode of every input,
+         * returning the resulting objects. The ThinLTO cache is kept in
+         * the given directory unless the options name another one.
+         */
+        std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> runLinkTimeOptimization(
+            std::vector<std::unique_ptr<llvm::MemoryBuffer>> bitcodeBuffers,
+            const std::optional<std::filesystem::path> &defaultCacheDirectory = std::nullopt
+        );
+
+        /**
+         * Link the given objects into the executable or shared object
+         * requested by the options. Returns true if successful, and false
+         * otherwise.
+         */
+        bool link(
+            const std::vector<std::unique_ptr<llvm::MemoryBuffer>> &objects,
+            const std::filesystem::path &artifactFilePath
+        );
+
+        /**
+         * Write the given objects into a static archive, under the given
+         * member names. Returns true if successful, and false otherwise.
+         */
+        bool archive(
+            const std::vector<std::unique_ptr<llvm::MemoryBuffer>> &objects,
+            const std::vector<std::string> &memberNames,
+            const std::filesystem::path &artifactFilePath
+        );
+    };
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+#include <ilc/processing/dependency_scanner.h>
+
+namespace ilc {
+    struct DependencyNode {
+        std::string inputFilePath;
+
+        std::string input;
+
+        SourceDependencies sourceDependencies;
+
+        /**
+         * Resolved paths of every file included by this input, either
+         * directly or through other included files.
+         */
+        std::set<std::string> includedFilePaths = {};
+
+        /**
+         * Indices of the input nodes which this node depends upon.
+         */
+        std::set<size_t> dependencies = {};
+
+        /**
+         * Indices of the input nodes which depend upon this node.
+         */
+        std::set<size_t> dependents = {};
+
+        /**
+         * Indices of the interface nodes of modules which this node
+         * refers to, but which no input declares.
+         */
+        std::set<size_t> interfaceDependencies = {};
+    };
+
+    /**
+     * The interface of a module which no input declares, loaded from an
+     * interface file written by a previous invocation.
+     */
+    struct InterfaceNode {
+        std::string interfaceFilePath;
+
+        std::string interface;
+
+        /**
+         * Indices of the interface nodes which this interface refers to.
+         */
+        std::set<size_t> dependencies = {};
+    };
+
+    /**
+     * A directed acyclic graph of the input files, where edges are
+     * derived from module references between inputs during a pre-scan.
+     * Include directives do not create edges between inputs, but are
+     * tracked per input for depfile emission. Modules which no input
+     * declares are resolved to the interface files written when they
+     * were compiled, if any.
+     */
+    class DependencyGraph {
+    private:
+        std::vector<DependencyNode> nodes = {};
+
+        /**
+         * Maps a module name to the index of the input which declares
+         * it. The first input to declare a module owns it.
+         */
+        std::map<std::string, size_t> moduleOwners = {};
+
+        std::vector<InterfaceNode> interfaceNodes = {};
+
+        /**
+         * Maps the name of a module which no input declares to the index
+         * of the interface node declaring it.
+         */
+        std::map<std::string, size_t> interfaceOwners = {};
+
+        static std::optional<std::filesystem::path> resolveIncludePath(
+            const std::filesystem::path &includingFilePath,
+            const std::string &includePath
+        );
+
+        void collectIncludes(
+            const std::filesystem::path &filePath,
+            const SourceDependencies &sourceDependencies,
+            std::set<std::string> &includedFilePaths
+        );
+
+        /**
+         * Load the interface declaring the given module, along with the
+         * interfaces which it refers to. Returns the index of the
+         * resulting node, or std::nullopt if no readable interface file
+         * declares the module.
+         */
+        std::optional<size_t> loadInterface(
+            const std::string &moduleName,
+            const std::map<std::string, std::filesystem::path> &interfaceFilePaths
+        );
+
+    public:
+        /**
+         * Register an input file along with its contents. Returns the
+         * index of the resulting node.
+         */
+        size_t addInput(std::string inputFilePath, std::string input);
+
+        /**
+         * Resolve module references into edges between the registered
+         * inputs. References to modules which no input declares are
+         * resolved to interface files found within the given
+         * directories. Must be invoked once all inputs have been added.
+         */
+        void link(const std::vector<std::filesystem::path> &interfaceSearchPaths = {});
+
+        [[nodiscard]] const std::vector<DependencyNode> &getNodes() const noexcept;
+
+        [[nodiscard]] const DependencyNode &getNode(size_t index) const;
+
+        [[nodiscard]] const std::vector<InterfaceNode> &getInterfaceNodes() const noexcept;
+
+        /**
+         * Compute a topological order of all nodes, dependencies first.
+         * Returns std::nullopt if the graph contains a cycle.
+         */
+        [[nodiscard]] std::optional<std::vector<size_t>> findTopologicalOrder() const;
+
+        /**
+         * Find every node which the given node depends upon, directly
+         * or transitively, ordered dependencies first. The given node
+         * itself is not included.
+         */
+        [[nodiscard]] std::vector<size_t> findTransitiveDependencies(size_t index) const;
+
+        /**
+         * Find every interface node which the given node depends upon,
+         * either directly, through the inputs it depends upon or through
+         * other interfaces, ordered dependencies first.
+         */
+        [[nodiscard]] std::vector<size_t> findInterfaceDependencies(size_t index) const;
+
+        /**
+         * Collect the prerequisites of the given node as expected by
+         * a depfile: the input itself, its includes, and the interface
+         * files of the inputs and other modules which it transitively
+         * depends upon. Dependents only ever see the interfaces of their
+         * dependencies, so editing a dependency's implementation leaves
+         * them up to date. The given paths hold the interface file
+         * written for each input node.
+         */
+        [[nodiscard]] std::vector<std::string> findPrerequisites(
+            size_t index,
+            const std::vector<std::string> &interfaceFilePaths
+        ) const;
+
+        /**
+         * Collect the prerequisites of an artifact combining the outputs
+         * of every node: every input, their includes, and the interface
+         * files of other modules which they depend upon.
+         */
+        [[nodiscard]] std::vector<std::string> findArtifactPrerequisites() const;
+    };
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ilc {
+    struct SourceDependencies {
+        /**
+         * Paths of '#include' directives, exactly as written in
+         * the source.
+         */
+        std::vector<std::string> includes = {};
+
+        std::set<std::string> declaredModules = {};
+
+        /**
+         * Names of modules referenced through 'import' or qualified
+         * ('name::') references. May contain modules declared by the
+         * same source.
+         */
+        std::set<std::string> referencedModules = {};
+    };
+
+    /**
+     * A lightweight pre-scan over source text which only recognizes
+     * what is required to compute dependencies between inputs. It
+     * skips comments and string literals but performs no lexing or
+     * parsing through ionlang, and is therefore cheap to run on every
+     * input before compilation begins.
+     */
+    class DependencyScanner {
+    public:
+        static SourceDependencies scan(const std::string &input);
+    };
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace ilc {
+    /**
+     * Emits Makefile-style dependency files, as understood by both
+     * Make and Ninja ('deps = gcc').
+     */
+    class Depfile {
+    private:
+        static std::string escape(const std::string &path);
+
+    public:
+        static std::filesystem::path makePath(const std::filesystem::path &outputFilePath);
+
+        /**
+         * Write a depfile declaring that the given target depends upon
+         * the given prerequisites. Returns true if successful, and false
+         * otherwise.
+         */
+        static bool write(
+            const std::filesystem::path &depfilePath,
+            const std::string &target,
+            const std::vector<std::string> &prerequisites
+        );
+    };
+}
@@ -1,23 +1,76 @@
 #pragma once
 
 #include <filesystem>
+#include <functional>
+#include <memory>
 #include <vector>
 #include <llvm/ADT/Triple.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/CodeGen/MachineModuleInfo.h>
 #include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Target/TargetMachine.h>
 #include <ionshared/misc/helpers.h>
 #include <ionlang/lexical/token.h>
 #include <ionlang/construct/module.h>
+#include <ionir/construct/module.h>
+#include <ilc/cli/console_color.h>
+#include <ilc/cli/options.h>
 #include <ilc/misc/helpers.h>
+#include <ilc/misc/size_report.h>
+#include <ilc/processing/input_classifier.h>
+#include <ilc/processing/remarks.h>
 
 namespace ilc {
+    struct DriverFrontendResult {
+        ionshared::Ptr<ionlang::Module> ionLangModule;
+
+        /**
+         * Only set if semantic analysis reported no errors.
+         */
+        ionshared::OptPtr<ionir::Module> ionIrModule;
+    };
+
+    /**
+     * Receives rendered diagnostics and every other output of the
+     * driver, such as phase banners and LLVM IR, in place of the
+     * standard output stream. Logging is not included.
+     */
+    typedef std::function<void(const std::string &text)> DiagnosticSink;
+
     class Driver {
     private:
+        cli::Options options;
+
+        DiagnosticSink diagnosticSink;
+
         std::filesystem::path outputFilePath;
 
         std::string input = "";
 
         std::optional<ionlang::TokenStream> tokenStream;
 
+        /**
+         * The resulting object code or, when using link-time optimization,
+         * LLVM bitcode of the last run.
+         */
+        std::unique_ptr<llvm::MemoryBuffer> outputBuffer = nullptr;
+
+        /**
+         * Sizes of the functions emitted by the last run, only measured
+         * when the size report is enabled.
+         */
+        std::vector<FunctionSize> functionSizes = {};
+
+        /**
+         * Owns the module loaded from the AST cache or from an LLVM
+         * input, if any. Declared before the module, so that it outlives
+         * it.
+         */
+        std::unique_ptr<llvm::LLVMContext> cachedModuleContext = nullptr;
+
+        std::unique_ptr<llvm::Module> cachedModule = nullptr;
+
         std::vector<ionlang::Token> lex();
 
         ionshared::OptPtr<ionlang::Module> parse(
@@ -25,25 +78,177 @@ namespace ilc {
             ionshared::Ptr<DiagnosticVector> diagnostics
         );
 
-        std::optional<std::vector<llvm::Module *>> lowerToLlvmIr(
+        /**
+         * Run the semantic passes over the module and lower it into
+         * IonIR, followed by the IonIR analysis passes. Returns the IonIR
+         * module if no errors were reported.
+         */
+        ionshared::OptPtr<ionir::Module> analyze(
             ionshared::Ptr<ionlang::Module> module,
             ionshared::Ptr<DiagnosticVector> diagnostics
         );
 
-        bool makeObjectCode(llvm::Triple targetTriple, llvm::Module *module);
+        /**
+         * Fold constant branches and remove unreachable blocks and dead
+         * code from the IonIR module before it is lowered, so that less
+         * of it reaches the LLVM pipeline. From -O2 onwards, functions
+         * unreachable from the entry point are stripped too. Only done
+         * when optimizing.
+         */
+        void optimizeIonIr(
+            ionshared::Ptr<ionir::Module> module,
+            ionshared::Ptr<DiagnosticVector> diagnostics
+        );
+
+        std::optional<std::vector<llvm::Module *>> lowerToLlvmIr(
+            ionshared::Ptr<ionir::Module> module,
+            ionshared::Ptr<DiagnosticVector> diagnostics
+        );
+
+        /**
+         * Run the LLVM optimization pipeline matching the optimization
+         * level given through the command-line over the module.
+         */
+        void optimize(llvm::TargetMachine *targetMachine, llvm::Module *module);
+
+        /**
+         * Generate machine code of the given file type for the module.
+         * Returns nullptr if LLVM cannot emit the file type. Machine
+         * functions already present in the given machine module info, if
+         * any, are emitted as-is; ownership of it passes to the code
+         * generator.
+         */
+        std::unique_ptr<llvm::MemoryBuffer> makeMachineCode(
+            llvm::TargetMachine *targetMachine,
+            llvm::Module *module,
+            llvm::TargetMachine::CodeGenFileType outputFileType,
+            llvm::MachineModuleInfo *machineModuleInfo = nullptr
+        );
+
+        /**
+         * Emit the module as object code. Machine functions already
+         * present in the given machine module info, if any, are emitted
+         * as-is; ownership of it passes to the code generator.
+         */
+        bool makeObjectCode(
+            llvm::TargetMachine *targetMachine,
+            llvm::Module *module,
+            llvm::MachineModuleInfo *machineModuleInfo = nullptr
+        );
+
+        /**
+         * Optimize and emit the module one function at a time, reusing
+         * object code cached by previous runs for unchanged functions.
+         */
+        bool makeIncrementalObjectCode(
+            const llvm::Triple &targetTriple,
+            llvm::TargetMachine *targetMachine,
+            llvm::Module *module
+        );
+
+        /**
+         * Emit the module as LLVM bitcode for the link-time step,
+         * including a module summary when using ThinLTO.
+         */
+        bool makeBitcode(llvm::Module *module);
+
+        bool writeOutputBuffer();
+
+        /**
+         * Write an artifact next to the output file, named after it with
+         * the given extension, such as '.ll'.
+         */
+        bool writeArtifact(const std::string &extension, llvm::StringRef contents);
+
+        /**
+         * Write the LLVM IR and bitcode artifacts requested through the
+         * command-line from the (optimized) module.
+         */
+        bool writeModuleArtifacts(llvm::Module *module);
+
+        /**
+         * Optimize and emit the LLVM module lowered from, or standing in
+         * for, the input, according to the command-line options.
+         */
+        bool emit(
+            const llvm::Triple &targetTriple,
+            llvm::Module *llvmModule,
+            const std::optional<RemarksOpts> &remarksOpts
+        );
+
+        /**
+         * Coat the text with the given color, unless colors are disabled
+         * by the driver's options.
+         */
+        [[nodiscard]] std::string coat(const std::string &text, ColorKind color) const;
+
+        /**
+         * Print the text to the sink, if any, or otherwise to the
+         * standard output stream.
+         */
+        void print(const std::string &text);
+
+        /**
+         * Discard the state of the previous run, if any, before starting
+         * a run over the given input.
+         */
+        void reset(std::filesystem::path outputFilePath, std::string input);
 
         void tryThrow(std::exception exception);
 
     public:
         /**
-         * Proceed to lex, parse, lower, and emit to either LLVM
-         * IR or object code. Returns true if successful, and false
-         * otherwise.
+         * Create a driver configured by the given options, rather than
+         * by those given through the command-line. Output is printed to
+         * the standard output stream unless a sink is given.
+         */
+        explicit Driver(cli::Options options = cli::options, DiagnosticSink diagnosticSink = nullptr);
+
+        /**
+         * Proceed to lex, parse, lower, optimize, and emit to either
+         * object code or, when using link-time optimization, LLVM
+         * bitcode, stopping early after the phase level given through
+         * the command-line, if any. Optimization remarks are streamed
+         * as described by the given remarks options, if any. Returns true
+         * if successful, and false otherwise.
          */
         bool run(
             llvm::Triple targetTriple,
             std::filesystem::path outputFilePath,
-            std::string input
+            std::string input,
+            std::optional<RemarksOpts> remarksOpts = std::nullopt
         );
+
+        /**
+         * Compile an LLVM IR, bitcode or MIR input, skipping the frontend
+         * entirely. Otherwise behaves as run(), except that no remarks
+         * are streamed for MIR.
+         */
+        bool runBackend(
+            llvm::Triple targetTriple,
+            std::filesystem::path outputFilePath,
+            std::string input,
+            InputKind inputKind,
+            std::optional<RemarksOpts> remarksOpts = std::nullopt
+        );
+
+        /**
+         * Only lex, parse and analyze the input, returning the resulting
+         * ASTs. Returns std::nullopt if the input could not be parsed.
+         */
+        std::optional<DriverFrontendResult> runFrontend(std::string input);
+
+        /**
+         * Take ownership of the output of the last successful run. Output
+         * is only written to disk when object emission was requested, so
+         * this is how linked artifacts obtain it.
+         */
+        std::unique_ptr<llvm::MemoryBuffer> takeOutputBuffer();
+
+        /**
+         * Take the sizes of the functions emitted by the last successful
+         * run, for the size report.
+         */
+        std::vector<FunctionSize> takeFunctionSizes();
     };
 }
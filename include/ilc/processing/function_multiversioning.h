@@ -0,0 +1,56 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Module.h>
+
+namespace ilc {
+    struct FunctionMultiversioningOpts {
+        /**
+         * Names of the functions to compile once per target level.
+         */
+        const std::vector<std::string> functionNames;
+
+        /**
+         * Names of the target levels, such as 'x86-64-v3'.
+         */
+        const std::vector<std::string> targetNames;
+    };
+
+    /**
+     * Compiles selected functions once per x86-64 micro-architecture
+     * level, besides their baseline version, and dispatches between them
+     * through an indirect function. The resolver runs once at load time,
+     * detecting the CPU's features itself through 'cpuid' and 'xgetbv',
+     * so that binaries do not depend on a compiler runtime for it.
+     */
+    class FunctionMultiversioning {
+    public:
+        /**
+         * Find the features a target level enables beyond the x86-64
+         * baseline, in the form of '+feature'. Returns std::nullopt if
+         * the level is unknown.
+         */
+        static std::optional<std::vector<std::string>> findTargetFeatures(const std::string &targetName);
+
+        /**
+         * Indirect functions are an ELF extension, and the levels are
+         * specific to x86-64.
+         */
+        static bool isSupported(const llvm::Triple &targetTriple);
+
+        /**
+         * Replace each selected function defined in the module with an
+         * indirect function of the same name. Selected functions not
+         * defined in the module are skipped. Returns true if successful,
+         * and false otherwise.
+         */
+        static bool apply(
+            llvm::Module &module,
+            const llvm::Triple &targetTriple,
+            const FunctionMultiversioningOpts &opts
+        );
+    };
+}
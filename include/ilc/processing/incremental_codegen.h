@@ -0,0 +1,96 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <llvm/ADT/Triple.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+namespace ilc {
+    struct IncrementalCodegenOpts {
+        const std::filesystem::path cacheDirectory;
+
+        /**
+         * Distinguishes the local symbols of this module from those of
+         * other inputs, once they have been promoted.
+         */
+        const std::string moduleTag;
+
+        /**
+         * Identifies everything besides the IR which affects the emitted
+         * code, such as the target and the optimization level.
+         */
+        const std::string configurationKey;
+
+        const llvm::Triple targetTriple;
+    };
+
+    /**
+     * Optimizes and emits a module into object code, returning nullptr
+     * upon failure.
+     */
+    typedef std::function<std::unique_ptr<llvm::MemoryBuffer>(llvm::Module &)> ModuleEmitter;
+
+    /**
+     * Emits a module one function at a time, reusing the object code of
+     * functions which did not change since a previous run. Each function
+     * is keyed by a hash of its IR, along with the signatures of every
+     * global it refers to, so that a function is only re-emitted when it
+     * changes or when something it depends upon changes shape. Global
+     * variables are emitted together as a single unit. The resulting
+     * objects are then combined through a relocatable link. Only code
+     * generation is incremental: the front-end still processes the
+     * whole input on every run.
+     */
+    class IncrementalCodegen {
+    private:
+        IncrementalCodegenOpts opts;
+
+        /**
+         * Make local symbols visible across the per-function objects,
+         * without exposing them outside the final shared object or
+         * executable.
+         */
+        void promoteLocalSymbols(llvm::Module &module) const;
+
+        /**
+         * Move the given definitions out of their module into a module of
+         * their own, in which everything else they refer to is declared.
+         * Leaves the definitions' functions as declarations, and their
+         * global variables without initializers.
+         */
+        static std::unique_ptr<llvm::Module> extractUnit(
+            llvm::Module &module,
+            const std::vector<llvm::GlobalValue *> &definitions
+        );
+
+        [[nodiscard]] std::string findUnitKey(
+            const llvm::Module &module,
+            const std::vector<const llvm::GlobalValue *> &definitions
+        ) const;
+
+        [[nodiscard]] std::filesystem::path findCacheFilePath(const std::string &key) const;
+
+        [[nodiscard]] std::unique_ptr<llvm::MemoryBuffer> loadCachedObject(const std::string &key) const;
+
+        void storeCachedObject(const std::string &key, const llvm::MemoryBuffer &object) const;
+
+    public:
+        /**
+         * Whether incremental code generation is available in this
+         * build. Combining objects requires the in-process linker.
+         */
+        static bool isAvailable() noexcept;
+
+        explicit IncrementalCodegen(IncrementalCodegenOpts opts);
+
+        /**
+         * Emit the module, promoting its local symbols in the process.
+         * Returns nullptr upon failure.
+         */
+        std::unique_ptr<llvm::MemoryBuffer> run(llvm::Module &module, const ModuleEmitter &emit);
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+
+namespace ilc {
+    enum class InputKind {
+        Ion,
+
+        /**
+         * Textual LLVM IR ('.ll').
+         */
+        LlvmIr,
+
+        LlvmBitcode,
+
+        /**
+         * LLVM machine IR ('.mir'), serialized after instruction
+         * selection.
+         */
+        Mir
+    };
+
+    /**
+     * Tells Ion sources apart from LLVM inputs, which bypass the
+     * frontend and are handed over to the backend directly. Inputs are
+     * recognized by their extension, and otherwise by their contents.
+     */
+    class InputClassifier {
+    public:
+        static InputKind classify(const std::string &inputFilePath, const std::string &input);
+
+        /**
+         * Whether inputs of the given kind skip the frontend.
+         */
+        static bool isBackendInput(InputKind kind) noexcept;
+    };
+}
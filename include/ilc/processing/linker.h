@@ -0,0 +1,107 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <llvm/ADT/Triple.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+namespace ilc {
+    enum class LinkKind {
+        Executable,
+
+        SharedObject,
+
+        /**
+         * Combine objects into a single object, which may itself be
+         * linked later on.
+         */
+        Relocatable
+    };
+
+    struct LinkerOpts {
+        const LinkKind kind;
+
+        const std::filesystem::path outputFilePath;
+
+        const llvm::Triple targetTriple;
+
+        /**
+         * Whether to remove unreferenced sections.
+         */
+        const bool gcSections = false;
+
+        /**
+         * Whether to fold identical code sections.
+         */
+        const bool icf = false;
+
+        /**
+         * Whether to link the C runtime start files and libraries.
+         */
+        const bool defaultLibraries = true;
+
+        /**
+         * Additional arguments forwarded to the linker as-is.
+         */
+        const std::vector<std::string> extraArguments = {};
+
+        /**
+         * Whether to link LLVM's profile runtime, which instrumented
+         * objects depend upon to write their profiles.
+         */
+        const bool profileRuntime = false;
+
+        /**
+         * Path of the profile runtime archive, if given explicitly.
+         * Otherwise, it is looked up amongst the installed Clang
+         * resource directories.
+         */
+        const std::optional<std::string> profileRuntimePath = std::nullopt;
+    };
+
+    /**
+     * Links in-memory objects into an executable or shared object using
+     * LLD's library interface, avoiding both spawning a linker process
+     * and writing the intermediate objects to disk where the platform
+     * allows it.
+     */
+    class Linker {
+    private:
+        LinkerOpts opts;
+
+        /**
+         * Find the path of the first existing C runtime file amongst the
+         * library directories of the target, if any.
+         */
+        [[nodiscard]] std::optional<std::string> findRuntimeFile(const std::string &fileName) const;
+
+        [[nodiscard]] std::vector<std::string> findLibraryDirectories() const;
+
+        [[nodiscard]] std::optional<std::string> findDynamicLinker() const;
+
+        /**
+         * Find the path of the profile runtime archive: the one given
+         * explicitly, or otherwise the one shipped with the installed
+         * Clang matching the LLVM version ilc was built against, falling
+         * back to the newest, if any.
+         */
+        [[nodiscard]] std::optional<std::string> findProfileRuntime() const;
+
+    public:
+        /**
+         * Whether in-process linking is available in this build.
+         */
+        static bool isAvailable() noexcept;
+
+        explicit Linker(LinkerOpts opts);
+
+        /**
+         * Link the given objects. Returns true if successful, and false
+         * otherwise.
+         */
+        bool link(const std::vector<std::unique_ptr<llvm::MemoryBuffer>> &objects);
+    };
+}
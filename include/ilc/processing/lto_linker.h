@@ -0,0 +1,83 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+#include <llvm/ADT/Triple.h>
+#include <llvm/Support/CodeGen.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <ilc/cli/options.h>
+
+namespace ilc {
+    struct LtoLinkerOpts {
+        const cli::LtoKind kind;
+
+        const llvm::Triple targetTriple;
+
+        const std::string cpuName;
+
+        const std::vector<std::string> cpuFeatures;
+
+        const unsigned optimizationLevel = 2;
+
+        const llvm::CodeGenOpt::Level codeGenOptimizationLevel = llvm::CodeGenOpt::Default;
+
+        /**
+         * Maximum amount of ThinLTO backends to run in parallel. A value
+         * of zero means one per available hardware thread.
+         */
+        const uint32_t jobs = 0;
+
+        /**
+         * Directory in which ThinLTO backend results are kept between
+         * runs. Caching is disabled when not set.
+         */
+        const std::optional<std::filesystem::path> cacheDirectory = std::nullopt;
+
+        /**
+         * Whether to internalize every symbol except the entry point.
+         */
+        const bool internalize = false;
+
+        /**
+         * File which to write optimization remarks of the link-time
+         * step to. ThinLTO backends each write to a file of their own,
+         * suffixed with their task number.
+         */
+        const std::optional<std::filesystem::path> remarksFilePath = std::nullopt;
+
+        const std::optional<std::string> remarksFilter = std::nullopt;
+    };
+
+    /**
+     * Performs the link-time step of link-time optimization over the
+     * bitcode emitted for each input file. Full LTO merges all modules
+     * into a single one before optimizing, while ThinLTO runs a backend
+     * per module in parallel, importing functions across modules based
+     * on their summaries.
+     */
+    class LtoLinker {
+    private:
+        LtoLinkerOpts opts;
+
+        /**
+         * Bitcode inputs must outlive the link step, since LLVM's LTO
+         * implementation refers to their contents lazily.
+         */
+        std::vector<std::unique_ptr<llvm::MemoryBuffer>> inputs = {};
+
+    public:
+        explicit LtoLinker(LtoLinkerOpts opts);
+
+        void addInput(std::unique_ptr<llvm::MemoryBuffer> input);
+
+        /**
+         * Run the link-time step, producing one native object per LTO
+         * task. Returns std::nullopt upon failure.
+         */
+        std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> link();
+    };
+}
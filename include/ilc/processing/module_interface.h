@@ -0,0 +1,55 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ilc {
+    /**
+     * Extracts the interface of a source: everything a dependent input
+     * needs to resolve names and check types against it, without any
+     * function bodies. Functions become externs of the same prototype,
+     * while modules, imports, externs, globals and type declarations
+     * are kept as-is. Comments are dropped and whitespace collapsed,
+     * keeping interfaces compact.
+     *
+     * Dependent inputs are given the interfaces of their dependencies
+     * instead of their full sources, so that the cost of an import does
+     * not grow with the size of the imported module's implementation.
+     * Modules compiled by previous invocations are imported through the
+     * interface files written next to their objects.
+     */
+    class ModuleInterface {
+    public:
+        static std::filesystem::path makePath(const std::filesystem::path &outputFilePath);
+
+        static std::string extract(const std::string &input);
+
+        /**
+         * Write the interface to the given path, unless the file already
+         * holds the exact same interface, so that its modification time
+         * only changes along with the interface itself. Returns true if
+         * successful, and false otherwise.
+         */
+        static bool write(const std::filesystem::path &interfaceFilePath, const std::string &interface);
+
+        /**
+         * Read the interface written to the given path. Returns
+         * std::nullopt if there is none, or if it was written by another
+         * version of ilc.
+         */
+        static std::optional<std::string> read(const std::filesystem::path &interfaceFilePath);
+
+        /**
+         * Find the interface file declaring each module within the given
+         * directories, searched recursively. Files written by another
+         * version of ilc are skipped, and earlier directories take
+         * precedence.
+         */
+        static std::map<std::string, std::filesystem::path> findInterfaceFiles(
+            const std::vector<std::filesystem::path> &searchPaths
+        );
+    };
+}
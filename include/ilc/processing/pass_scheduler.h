@@ -0,0 +1,95 @@
+#pragma once
+
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+#include <ionir/passes/pass.h>
+#include <ilc/misc/helpers.h>
+
+namespace ilc {
+    /**
+     * Parts of the compilation state which passes may read or write.
+     * Diagnostics are not a resource, since every pass reports to its
+     * own context.
+     */
+    enum class PassResource {
+        Ast,
+
+        SymbolTable,
+
+        Types
+    };
+
+    /**
+     * Creates a pass reporting to the given context.
+     */
+    typedef std::function<ionshared::Ptr<ionir::Pass>(ionshared::Ptr<ionshared::PassContext>)> PassFactory;
+
+    struct ScheduledPass {
+        const std::string name;
+
+        const PassFactory factory;
+
+        const std::set<PassResource> reads;
+
+        const std::set<PassResource> writes = {};
+
+        /**
+         * Whether the pass inspects each top-level construct of a module
+         * independently, and may therefore be run over shards of a
+         * module's functions rather than over the module as a whole.
+         */
+        const bool functionGranular = false;
+    };
+
+    /**
+     * Runs IonIR passes according to the resources they declare. Passes
+     * are grouped into stages in registration order; a pass joins the
+     * current stage unless it conflicts with a pass already in it, in
+     * which case it begins a new stage. The passes of a stage run
+     * concurrently over the same AST, each reporting to its own
+     * diagnostics vector, which are then merged in registration order
+     * so that the result does not depend on scheduling. Function-granular
+     * passes are further split into shards of a module's top-level
+     * constructs, each shard reporting to its own context, preceded by
+     * a visit of the modules themselves, without their children. When
+     * run from within a thread pool's task, no more threads than the
+     * pool allows are used.
+     */
+    class PassScheduler {
+    private:
+        std::vector<ScheduledPass> passes = {};
+
+        uint32_t jobs;
+
+        static bool conflicts(const ScheduledPass &first, const ScheduledPass &second);
+
+        /**
+         * Split the top-level constructs of the AST's modules into
+         * contiguous shards, preserving source order.
+         */
+        [[nodiscard]] static std::vector<ionir::Ast> findShards(const ionir::Ast &ast, uint32_t jobs);
+
+    public:
+        /**
+         * A jobs value of zero means one job per available hardware
+         * thread.
+         */
+        explicit PassScheduler(uint32_t jobs = 0);
+
+        void registerPass(ScheduledPass pass);
+
+        /**
+         * Group the registered passes into stages. Each stage contains
+         * indices of passes which may safely run concurrently.
+         */
+        [[nodiscard]] std::vector<std::vector<size_t>> findStages() const;
+
+        /**
+         * Run all registered passes over the AST, appending all reported
+         * diagnostics to the given vector.
+         */
+        void run(const ionir::Ast &ast, ionshared::Ptr<DiagnosticVector> diagnostics);
+    };
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/ToolOutputFile.h>
+
+namespace ilc {
+    struct RemarksOpts {
+        const std::filesystem::path remarksFilePath;
+
+        /**
+         * Regular expression matched against the names of the passes
+         * whose remarks to keep. Keeps all remarks when not set.
+         */
+        const std::optional<std::string> filter = std::nullopt;
+    };
+
+    /**
+     * Streams LLVM optimization remarks (such as those of the inliner,
+     * the loop vectorizer or LICM) of each compiled module into a file.
+     * Remarks name the function they concern. Since IonIR emits no
+     * debug information, they carry no source location unless the
+     * compiled module has its own, such as LLVM inputs compiled with it.
+     */
+    class Remarks {
+    public:
+        /**
+         * Find the remarks file of a single compilation unit, derived
+         * from the given remarks output by inserting the unit's name
+         * before its extension.
+         */
+        static std::filesystem::path makePath(
+            const std::filesystem::path &remarksOutputPath,
+            const std::string &unitName
+        );
+
+        /**
+         * Find the serialization format for the given remarks file,
+         * based upon its extension.
+         */
+        static std::string findFormat(const std::filesystem::path &remarksFilePath);
+
+        /**
+         * Begin streaming the remarks of the given context into the
+         * remarks file. Streaming stops when the returned file is passed
+         * to finish(). Returns nullptr upon failure.
+         */
+        static std::unique_ptr<llvm::ToolOutputFile> begin(llvm::LLVMContext &context, const RemarksOpts &opts);
+
+        static void finish(llvm::LLVMContext &context, std::unique_ptr<llvm::ToolOutputFile> remarksFile);
+    };
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ilc {
+    struct PreludeFile {
+        std::string filePath;
+
+        std::string source;
+    };
+
+    /**
+     * The part of the compiler's state which would otherwise be
+     * recomputed by every invocation.
+     */
+    struct SnapshotData {
+        std::string hostTriple;
+
+        std::string hostCpuName;
+
+        std::vector<std::string> hostCpuFeatures;
+
+        /**
+         * Interfaces of all prelude files, in order, which are prepended
+         * to every input.
+         */
+        std::string prelude;
+
+        /**
+         * Sources of all prelude files, in order, whose definitions are
+         * compiled into objects of their own.
+         */
+        std::vector<PreludeFile> preludeFiles;
+    };
+
+    /**
+     * Saves the host's target description, the prelude's sources and
+     * their extracted interfaces into a single file, which later
+     * invocations map into memory instead of querying the host and
+     * reading and extracting the prelude again. Snapshots are tied to
+     * the machine and to the LLVM version they were created with, and
+     * must be created again whenever the prelude changes.
+     */
+    class Snapshot {
+    private:
+        static std::optional<SnapshotData> &getActiveStorage();
+
+    public:
+        /**
+         * Read the given prelude files, in order. Returns std::nullopt if
+         * a prelude file could not be read.
+         */
+        static std::optional<std::vector<PreludeFile>> readPrelude(const std::vector<std::string> &preludeFilePaths);
+
+        /**
+         * Concatenate the interfaces of the given prelude files.
+         */
+        static std::string extractPrelude(const std::vector<PreludeFile> &preludeFiles);
+
+        /**
+         * Compute the snapshot's contents from scratch, extracting the
+         * interfaces of the given prelude files. Returns std::nullopt if
+         * a prelude file could not be read.
+         */
+        static std::optional<SnapshotData> create(const std::vector<std::string> &preludeFilePaths);
+
+        static bool write(const std::filesystem::path &snapshotFilePath, const SnapshotData &data);
+
+        /**
+         * Load the snapshot at the given path. Returns std::nullopt if it
+         * could not be read, if it was created by another version of ilc
+         * or LLVM, or if it describes another host than the running one,
+         * whose CPU code would otherwise silently be generated for.
+         */
+        static std::optional<SnapshotData> load(const std::filesystem::path &snapshotFilePath);
+
+        /**
+         * Make the given snapshot visible to the rest of the compiler.
+         * Must be invoked before any input is processed, as the active
+         * snapshot is read without synchronization.
+         */
+        static void activate(SnapshotData data);
+
+        static const std::optional<SnapshotData> &getActive();
+    };
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <llvm/ADT/Triple.h>
+#include <llvm/Support/CodeGen.h>
+#include <llvm/Target/TargetMachine.h>
+#include <ilc/cli/options.h>
+
+namespace ilc {
+    /**
+     * Configuration shared by every stage which needs to know about
+     * the target, such as code generation and link-time optimization.
+     */
+    class TargetSetup {
+    public:
+        /**
+         * Register the LLVM backend responsible for the given triple,
+         * or every backend if the triple's architecture is unknown.
+         * Backends are only ever registered once, and only when first
+         * needed, since registering all of them is a significant part
+         * of start-up time. Safe to invoke from multiple drivers running
+         * in parallel.
+         */
+        static void initializeTarget(const llvm::Triple &targetTriple);
+
+        /**
+         * Find the name of the build host's CPU, or a generic CPU name
+         * when cross-compiling.
+         */
+        static std::string findCpuName(const llvm::Triple &targetTriple);
+
+        /**
+         * Find the features of the build host's CPU, in the form of
+         * '+feature' or '-feature'. Empty when cross-compiling.
+         */
+        static std::vector<std::string> findCpuFeatures(const llvm::Triple &targetTriple);
+
+        /**
+         * Query the features of the running host's CPU, in the same form
+         * as findCpuFeatures(), regardless of the active snapshot.
+         */
+        static std::vector<std::string> findHostCpuFeatures();
+
+        /**
+         * Find the CPU to generate code for under the given options. This
+         * is the build host's CPU, unless functions are multiversioned,
+         * in which case the rest of the code must run anywhere, and the
+         * architecture's baseline is used instead.
+         */
+        static std::string findCpuName(const llvm::Triple &targetTriple, const cli::Options &options);
+
+        /**
+         * Find the CPU features to generate code for under the given
+         * options, matching findCpuName().
+         */
+        static std::vector<std::string> findCpuFeatures(
+            const llvm::Triple &targetTriple,
+            const cli::Options &options
+        );
+
+        /**
+         * Map the optimization level of the given options into LLVM's
+         * numeric optimization level (0-3).
+         */
+        static unsigned findOptimizationLevel(const cli::Options &options);
+
+        /**
+         * Map the optimization level of the given options into LLVM's
+         * size level (0 for none, 1 for 's', 2 for 'z').
+         */
+        static unsigned findSizeLevel(const cli::Options &options);
+
+        /**
+         * Map the optimization level of the given options into the
+         * equivalent code generation optimization level.
+         */
+        static llvm::CodeGenOpt::Level findCodeGenOptimizationLevel(const cli::Options &options);
+
+        /**
+         * Describe every setting which affects the code emitted for the
+         * given triple under the given options, for use in cache keys.
+         */
+        static std::string findConfigurationKey(
+            const llvm::Triple &targetTriple,
+            const cli::Options &options
+        );
+
+        /**
+         * Create a target machine for the given triple, configured by
+         * the given options. Returns nullptr if the target could not be
+         * found.
+         */
+        static std::unique_ptr<llvm::TargetMachine> createTargetMachine(
+            const llvm::Triple &targetTriple,
+            const cli::Options &options
+        );
+    };
+}
@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+
+# Helpers shared by the benchmark scripts, which source this file after
+# setting 'ilc' to the path of the executable under test. Creates a
+# temporary working directory, 'work_dir', removed upon exit.
+
+if [[ ! -x "$ilc" ]]; then
+    echo "ilc executable not found at '$ilc'" >&2
+    exit 1
+fi
+
+work_dir="$(mktemp -d)"
+trap 'rm -rf "$work_dir"' EXIT
+
+now_ns() {
+    date +%s%N
+}
+
+# Print the median of the numbers read from the standard input, one per line.
+median() {
+    sort -n | awk '{ values[NR] = $1 } END { print values[int((NR + 1) / 2)] }'
+}
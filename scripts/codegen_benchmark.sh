@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+
+# Compare ilc's compile time with and without --fast-codegen, at both an
+# unoptimized and an optimized level. Each configuration compiles the
+# same inputs from scratch, bypassing the AST cache.
+#
+# Usage: scripts/codegen_benchmark.sh [path/to/ilc] [runs] [inputs...]
+#
+# Without inputs, a synthetic source of many small functions is used.
+
+set -euo pipefail
+
+ilc="${1:-build/ilc}"
+runs="${2:-5}"
+inputs=("${@:3}")
+
+source "$(dirname "${BASH_SOURCE[0]}")/benchmark_common.sh"
+
+if [[ ${#inputs[@]} -eq 0 ]]; then
+    input_file="$work_dir/main.ion"
+
+    {
+        echo "module main;"
+
+        for ((i = 0; i < 2000; i++)); do
+            printf '\nfn f%d() -> i32 {\n    return %d;\n}\n' "$i" "$i"
+        done
+
+        printf '\nfn main() -> i32 {\n    return 0;\n}\n'
+    } > "$input_file"
+
+    inputs=("$input_file")
+fi
+
+# Print the milliseconds taken by a full compilation of every input.
+time_compilation() {
+    local start
+    local end
+
+    rm -rf "$work_dir/out"
+    start="$(now_ns)"
+    "$ilc" --no-ast-cache -o "$work_dir/out" "$@" "${inputs[@]}" > /dev/null
+    end="$(now_ns)"
+
+    echo $(((end - start) / 1000000))
+}
+
+benchmark() {
+    local name="$1"
+    shift
+
+    local elapsed
+    elapsed="$(for ((i = 0; i < runs; i++)); do time_compilation "$@"; done | median)"
+
+    printf "%-20s median of %s %8s ms\n" "$name" "$runs" "$elapsed"
+}
+
+benchmark "O0" -O 0
+benchmark "O0 fast-codegen" -O 0 --fast-codegen
+benchmark "O2" -O 2
+benchmark "O2 fast-codegen" -O 2 --fast-codegen
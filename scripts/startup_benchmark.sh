@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+
+# Measure ilc's time to first output, both cold (binary evicted from the
+# page cache) and warm, across commands ranging from ones that never touch
+# LLVM to a full code generation run.
+#
+# Usage: scripts/startup_benchmark.sh [path/to/ilc] [runs]
+
+set -euo pipefail
+
+ilc="${1:-build/ilc}"
+runs="${2:-10}"
+
+source "$(dirname "${BASH_SOURCE[0]}")/benchmark_common.sh"
+
+input_file="$work_dir/main.ion"
+
+cat > "$input_file" <<'ION'
+module main;
+
+fn main() -> i32 {
+    return 0;
+}
+ION
+
+# Drop the executable from the page cache, to approximate a cold start
+# without requiring root to drop all caches.
+evict() {
+    dd if="$ilc" iflag=nocache count=0 status=none 2>/dev/null || true
+}
+
+# Print the milliseconds elapsed until the command writes its first byte.
+time_to_first_output() {
+    local start
+    local end
+
+    start="$(now_ns)"
+
+    # Reading stops after the first byte; the command is left to finish.
+    { head -c 1 > /dev/null; end="$(now_ns)"; cat > /dev/null; echo $(((end - start) / 1000000)); } \
+        < <("$ilc" "$@" 2>&1 || true)
+}
+
+benchmark() {
+    local name="$1"
+    shift
+
+    evict
+    local cold
+    cold="$(time_to_first_output "$@")"
+
+    local warm
+    warm="$(for ((i = 0; i < runs; i++)); do time_to_first_output "$@"; done | median)"
+
+    printf "%-12s cold %6s ms   warm (median of %s) %6s ms\n" "$name" "$cold" "$runs" "$warm"
+}
+
+benchmark "version" version
+benchmark "help" --help
+benchmark "check" check "$input_file"
+benchmark "compile" -o "$work_dir/out" "$input_file"
@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <llvm/Support/Format.h>
+#include <ilc/ast/ast_tracer.h>
+
+// Amount of the largest top-level subtrees to list.
+#define ILC_AST_TRACER_LARGEST_SUBTREES 10
+
+namespace ilc {
+    void AstTraceStatistics::print(llvm::raw_ostream &output) const {
+        output << "Nodes: " << this->nodeCount << ", maximum depth: " << this->maxDepth << '\n';
+
+        std::vector<std::pair<std::string, size_t>> nodeCounts =
+            std::vector<std::pair<std::string, size_t>>(this->nodeCountsByKind.begin(), this->nodeCountsByKind.end());
+
+        std::stable_sort(nodeCounts.begin(), nodeCounts.end(), [](const auto &first, const auto &second) {
+            return first.second > second.second;
+        });
+
+        for (const auto &[kindName, count] : nodeCounts) {
+            output << llvm::format("  %-24s %10zu\n", kindName.c_str(), count);
+        }
+
+        std::vector<std::pair<std::string, size_t>> largestSubtrees = this->subtreeSizes;
+        size_t listedSubtreeCount = std::min<size_t>(largestSubtrees.size(), ILC_AST_TRACER_LARGEST_SUBTREES);
+
+        std::partial_sort(
+            largestSubtrees.begin(),
+            largestSubtrees.begin() + listedSubtreeCount,
+            largestSubtrees.end(),
+
+            [](const auto &first, const auto &second) {
+                return first.second > second.second;
+            }
+        );
+
+        if (listedSubtreeCount > 0) {
+            output << "Largest top-level subtrees (approximate):\n";
+        }
+
+        for (size_t i = 0; i < listedSubtreeCount; i++) {
+            output << llvm::format(
+                "  %-24s %10zu bytes\n",
+                largestSubtrees[i].first.c_str(),
+                largestSubtrees[i].second
+            );
+        }
+    }
+}
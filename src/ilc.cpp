@@ -1,23 +1,30 @@
 // Include the cross-platform header before anything else.
 #include <ilc/cli/cross_platform.h>
 
-#include <queue>
-#include <filesystem>
+#include <map>
+#include <sstream>
 #include <CLI11/CLI11.hpp>
 #include <ionshared/misc/util.h>
-#include <ionlang/misc/static_init.h>
-#include <ionir/construct/type/void_type.h>
-#include <ionir/construct/prototype.h>
+#include <ilc/ast/ast_tracer.h>
+#include <ilc/misc/const.h>
+#include <ilc/misc/file_system.h>
+#include <ilc/misc/function_time_report.h>
 #include <ilc/misc/log.h>
+#include <ilc/misc/perf_counters.h>
+#include <ilc/misc/size_report.h>
+#include <ilc/misc/statistics.h>
 #include <ilc/jit/jit_driver.h>
 #include <ilc/jit/jit.h>
+#include <ilc/processing/build_session.h>
 #include <ilc/processing/driver.h>
+#include <ilc/processing/function_multiversioning.h>
+#include <ilc/processing/snapshot.h>
 #include <ilc/cli/commands.h>
 
 #define ILC_CLI_COMMAND_TRACE "trace"
 #define ILC_CLI_COMMAND_JIT "jit"
+#define ILC_CLI_COMMAND_CHECK "check"
 #define ILC_CLI_COMMAND_VERSION "version"
-#define ILC_CLI_VERSION "1.0.0"
 
 using namespace ilc;
 
@@ -25,7 +32,16 @@ void setupCli(CLI::App &app) {
     // Command(s).
     cli::traceCommand = app.add_subcommand(
         ILC_CLI_COMMAND_TRACE,
-        "Trace resulting abstract syntax tree (AST)"
+        "Trace the ionlang and IonIR abstract syntax trees (ASTs) of input files"
+    );
+
+    // Input files are declared once, on the app, and reached through fallthrough.
+    cli::traceCommand->fallthrough();
+
+    cli::traceCommand->add_flag(
+        "-s,--summary",
+        cli::options.traceSummaryOnly,
+        "Only print statistics, omitting the trace of each construct"
     );
 
     cli::jitCommand = app.add_subcommand(
@@ -33,11 +49,23 @@ void setupCli(CLI::App &app) {
         "Use JIT to compile code REPL-style"
     );
 
+    cli::versionCommand = app.add_subcommand(
+        ILC_CLI_COMMAND_VERSION,
+        "Display the version of ilc"
+    );
+
+    cli::checkCommand = app.add_subcommand(
+        ILC_CLI_COMMAND_CHECK,
+        "Only report diagnostics, without generating any code"
+    );
+
+    cli::checkCommand->fallthrough();
+
     // Option(s).
     app.add_option(
         "files",
         cli::options.inputFilePaths,
-        "Input files to process"
+        "Input files to process: Ion sources, or LLVM IR (.ll), bitcode (.bc) and MIR (.mir) files"
     )->check(CLI::ExistingFile);
 
     app.add_option("-p,--passes", [&](std::vector<std::string> passes) {
@@ -71,23 +99,312 @@ void setupCli(CLI::App &app) {
         return true;
     })->default_str("macro-expansion,name-resolution,type-check,borrow-check");
 
-    app.add_option("-l,--phase-level", cli::options.phaseLevel)
+    app.add_option(
+        "-l,--phase-level",
+        cli::options.phaseLevel,
+        "Last phase to run (0: lexing, 1: parsing, 2: semantic, 3: code generation)"
+    )
         ->check(CLI::Range(0, 3))
         ->default_val(std::to_string((int)cli::options.phaseLevel));
 
+    app.add_option("--target", [&](std::vector<std::string> values) {
+        cli::options.target = values.back();
+
+        return true;
+    }, "Target triple to generate code for; only its backend is initialized (defaults to the host)");
+
+    app.add_option(
+        "--prelude",
+        cli::options.preludeFilePaths,
+        "File whose declarations are made available to every input, and whose definitions are compiled alongside them"
+    )->check(CLI::ExistingFile);
+
+    app.add_option(
+        "--module-path",
+        cli::options.modulePaths,
+        "Directory searched for the interfaces (.ioni) of imported modules which are not among the inputs"
+    )->check(CLI::ExistingDirectory);
+
+    app.add_option("--snapshot-create", [&](std::vector<std::string> values) {
+        cli::options.snapshotCreatePath = values.back();
+
+        return true;
+    }, "Save the host's target description and the prelude into a snapshot file, then exit");
+
+    app.add_option("--snapshot", [&](std::vector<std::string> values) {
+        cli::options.snapshotPath = values.back();
+
+        return true;
+    }, "Load a snapshot created through --snapshot-create instead of recomputing its contents");
+
     app.add_option(
         "-o,--out",
         cli::options.out,
         "The directory onto which to write output"
     )->default_val(cli::options.out);
 
+    app.add_option("-O,--opt-level", [&](std::vector<std::string> values) {
+        const std::map<std::string, cli::OptimizationLevel> optimizationLevels = {
+            {"0", cli::OptimizationLevel::O0},
+            {"1", cli::OptimizationLevel::O1},
+            {"2", cli::OptimizationLevel::O2},
+            {"3", cli::OptimizationLevel::O3},
+            {"s", cli::OptimizationLevel::Os},
+            {"z", cli::OptimizationLevel::Oz}
+        };
+
+        auto optimizationLevel = optimizationLevels.find(values.back());
+
+        if (optimizationLevel == optimizationLevels.end()) {
+            return false;
+        }
+
+        cli::options.optimizationLevel = optimizationLevel->second;
+
+        return true;
+    }, "Optimization level (0, 1, 2, 3, s or z)")->default_str("0");
+
+    app.add_flag(
+        "--fast-codegen",
+        cli::options.fastCodegen,
+        "Generate machine code as fast as possible, for edit-compile-test loops; the LLVM IR is still optimized according to --opt-level"
+    );
+
+    app.add_option("--lto", [&](std::vector<std::string> values) {
+        if (values.back() == "thin") {
+            cli::options.lto = cli::LtoKind::Thin;
+        }
+        else if (values.back() == "full") {
+            cli::options.lto = cli::LtoKind::Full;
+        }
+        else {
+            return false;
+        }
+
+        return true;
+    }, "Optimize across all input files at link-time (thin or full)");
+
+    app.add_option("--lto-cache-dir", [&](std::vector<std::string> values) {
+        cli::options.ltoCacheDirectory = values.back();
+
+        return true;
+    }, "Directory in which to cache ThinLTO results between runs");
+
+    app.add_option("--remarks-output", [&](std::vector<std::string> values) {
+        cli::options.remarksOutput = values.back();
+
+        return true;
+    }, "File which to write LLVM optimization remarks to (.yaml or .bitstream)");
+
+    app.add_option("--remarks-filter", [&](std::vector<std::string> values) {
+        cli::options.remarksFilter = values.back();
+
+        return true;
+    }, "Regular expression selecting the passes whose remarks to keep");
+
+    app.add_option("--incremental-cache-dir", [&](std::vector<std::string> values) {
+        cli::options.incrementalCacheDirectory = values.back();
+
+        return true;
+    }, "Directory in which to cache per-function object code between runs");
+
+    app.add_option("--emit", [&](std::vector<std::string> values) {
+        cli::options.emit.clear();
+
+        for (const auto &value : values) {
+            std::stringstream valueStream = std::stringstream(value);
+            std::string kind;
+
+            // Accept both comma-separated and repeated values.
+            while (std::getline(valueStream, kind, ',')) {
+                if (kind == "obj") {
+                    cli::options.emit.insert(cli::EmitKind::Object);
+                }
+                else if (kind == "exe") {
+                    cli::options.emit.insert(cli::EmitKind::Executable);
+                }
+                else if (kind == "shared") {
+                    cli::options.emit.insert(cli::EmitKind::SharedObject);
+                }
+                else if (kind == "archive") {
+                    cli::options.emit.insert(cli::EmitKind::Archive);
+                }
+                else if (kind == "asm") {
+                    cli::options.emit.insert(cli::EmitKind::Assembly);
+                }
+                else if (kind == "llvm-ir") {
+                    cli::options.emit.insert(cli::EmitKind::LlvmIr);
+                }
+                else if (kind == "llvm-bc") {
+                    cli::options.emit.insert(cli::EmitKind::LlvmBitcode);
+                }
+                else {
+                    return false;
+                }
+            }
+        }
+
+        return !cli::options.emit.empty();
+    }, "Artifacts to emit (obj, exe, shared, archive, asm, llvm-ir, llvm-bc); asm, llvm-ir and llvm-bc are written next to each object, from the same optimized module; when linking or archiving, intermediate objects are only written if obj is also given")
+        ->default_str("obj");
+
+    app.add_option(
+        "--link-arg",
+        cli::options.linkerArguments,
+        "Argument to forward to the linker as-is"
+    );
+
+    app.add_option("--multiversion", [&](std::vector<std::string> values) {
+        for (const auto &value : values) {
+            std::stringstream valueStream = std::stringstream(value);
+            std::string functionName;
+
+            // Accept both comma-separated and repeated values.
+            while (std::getline(valueStream, functionName, ',')) {
+                cli::options.multiversionFunctions.push_back(functionName);
+            }
+        }
+
+        return true;
+    }, "Functions to compile for each --multiversion-targets level, dispatched at load time (x86-64 ELF only)");
+
+    app.add_option("--multiversion-targets", [&](std::vector<std::string> values) {
+        cli::options.multiversionTargets.clear();
+
+        for (const auto &value : values) {
+            std::stringstream valueStream = std::stringstream(value);
+            std::string targetName;
+
+            while (std::getline(valueStream, targetName, ',')) {
+                if (!FunctionMultiversioning::findTargetFeatures(targetName).has_value()) {
+                    return false;
+                }
+
+                cli::options.multiversionTargets.push_back(targetName);
+            }
+        }
+
+        return !cli::options.multiversionTargets.empty();
+    }, "Levels to compile multiversioned functions for (x86-64-v2, x86-64-v3, x86-64-v4)")
+        ->default_str("x86-64-v2,x86-64-v3,x86-64-v4");
+
+    app.add_flag(
+        "--profile-generate",
+        cli::options.profileGenerate,
+        "Instrument code to write an execution profile upon exit, for use with --profile-use once merged by llvm-profdata"
+    );
+
+    app.add_option("--profile-use", [&](std::vector<std::string> values) {
+        cli::options.profileUse = values.back();
+
+        return true;
+    }, "Indexed profile (.profdata) guiding optimization with branch weights and call counts")
+        ->check(CLI::ExistingFile);
+
+    app.add_option("--profile-runtime", [&](std::vector<std::string> values) {
+        cli::options.profileRuntime = values.back();
+
+        return true;
+    }, "Profile runtime archive (libclang_rt.profile) to link instrumented programs with")
+        ->check(CLI::ExistingFile);
+
+    app.add_option(
+        "-j,--jobs",
+        cli::options.jobs,
+        "Maximum amount of input files to compile in parallel (0 for one per hardware thread)"
+    )->default_val(std::to_string(cli::options.jobs));
+
     // Flag(s).
     app.add_flag("-c,--color", cli::options.noColor);
 
+    app.add_flag(
+        "--lto-internalize",
+        cli::options.ltoInternalize,
+        "Internalize all symbols except the entry point during link-time optimization"
+    );
+
+    app.add_flag(
+        "--incremental",
+        cli::options.incremental,
+        "Only re-emit the machine code of functions which changed since the previous run"
+    );
+
+    app.add_flag(
+        "--gc-sections",
+        cli::options.gcSections,
+        "Remove functions and data unreachable from the entry point and exported symbols when linking"
+    );
+
+    app.add_flag(
+        "--icf",
+        cli::options.icf,
+        "Fold identical code when linking"
+    );
+
+    app.add_flag(
+        "--no-default-libs",
+        cli::options.noDefaultLibraries,
+        "Do not link the C runtime start files and libraries"
+    );
+
+    app.add_flag(
+        "--no-depfile",
+        cli::options.noDepfile,
+        "Do not write Makefile-style depfiles next to the output files"
+    );
+
+    app.add_flag(
+        "--no-ast-cache",
+        cli::options.noAstCache,
+        "Do not cache the result of lexing, parsing and lowering each input"
+    );
+
+    app.add_flag(
+        "--stats",
+        cli::options.stats,
+        "Print compile statistics upon exit"
+    );
+
+    app.add_flag(
+        "--stats-json",
+        cli::options.statsJson,
+        "Print compile statistics upon exit, as JSON"
+    );
+
+    app.add_flag(
+        "--perf-counters",
+        cli::options.perfCounters,
+        "Print hardware performance counters of each compiler phase upon exit"
+    );
+
+    app.add_flag(
+        "--ftime-report-functions",
+        cli::options.functionTimeReport,
+        "Print the compile time of the slowest functions, per phase, upon exit"
+    );
+
+    app.add_option(
+        "--ftime-report-limit",
+        cli::options.functionTimeReportLimit,
+        "Amount of functions listed by --ftime-report-functions"
+    )->default_val(std::to_string(cli::options.functionTimeReportLimit));
+
+    app.add_flag(
+        "--size-report",
+        cli::options.sizeReport,
+        "Print the machine code size, stack frame size and inlined callees of each function upon exit, per source file and module"
+    );
+
+    app.add_flag(
+        "--size-report-json",
+        cli::options.sizeReportJson,
+        "Print the size report upon exit, as JSON"
+    );
+
     app.add_flag(
         "-i,--llvm-ir",
         cli::options.llvmIr,
-        "Whether to emit LLVM IR or LLVM bitcode"
+        "Also emit LLVM IR; equivalent to adding llvm-ir to --emit"
     );
 
     cli::jitCommand->add_flag(
@@ -105,8 +422,82 @@ int main(int argc, char **argv) {
     // Parse arguments.
     CLI11_PARSE(app, argc, argv);
 
-    // Static initialization(s).
-    ionlang::static_init::init();
+    // Checking stops after semantic analysis, unless an earlier phase was given.
+    if (cli::checkCommand->parsed()) {
+        cli::options.diagnosticsOnly = true;
+
+        if (cli::options.phaseLevel == cli::PhaseLevel::CodeGeneration) {
+            cli::options.phaseLevel = cli::PhaseLevel::Semantic;
+        }
+    }
+
+    if (cli::options.llvmIr) {
+        cli::options.emit.insert(cli::EmitKind::LlvmIr);
+    }
+
+    if (cli::options.profileGenerate && cli::options.profileUse.has_value()) {
+        log::error("Cannot both generate and use a profile at once");
+
+        return EXIT_FAILURE;
+    }
+
+    // Answered before anything else is initialized.
+    if (cli::versionCommand->parsed()) {
+        std::cout << Const::appName << " " << ILC_CLI_VERSION << std::endl;
+
+        return EXIT_SUCCESS;
+    }
+
+    // Enabled before any thread is started, so that every count is kept.
+    if (cli::options.stats || cli::options.statsJson) {
+        Statistics::enable(cli::options.statsJson ? StatisticsFormat::Json : StatisticsFormat::Table);
+    }
+
+    if (cli::options.perfCounters) {
+        PerfCounters::enable();
+    }
+
+    if (cli::options.functionTimeReport) {
+        FunctionTimeReport::enable(cli::options.functionTimeReportLimit);
+    }
+
+    if (cli::options.sizeReport || cli::options.sizeReportJson) {
+        SizeReport::enable(cli::options.sizeReportJson ? SizeReportFormat::Json : SizeReportFormat::Table);
+
+        if (cli::options.lto != cli::LtoKind::None) {
+            log::warning("Machine code is only generated at link time when using link-time optimization; the size report lacks code and stack sizes");
+        }
+    }
+
+    if (cli::options.snapshotCreatePath.has_value()) {
+        std::optional<SnapshotData> snapshotData = Snapshot::create(cli::options.preludeFilePaths);
+
+        if (!snapshotData.has_value()) {
+            log::error("Could not read prelude files");
+
+            return EXIT_FAILURE;
+        }
+        else if (!Snapshot::write(*cli::options.snapshotCreatePath, *snapshotData)) {
+            log::error("Could not write snapshot '" + *cli::options.snapshotCreatePath + "'");
+
+            return EXIT_FAILURE;
+        }
+
+        log::success("Created snapshot '" + *cli::options.snapshotCreatePath + "'");
+
+        return EXIT_SUCCESS;
+    }
+    else if (cli::options.snapshotPath.has_value()) {
+        std::optional<SnapshotData> snapshotData = Snapshot::load(*cli::options.snapshotPath);
+
+        // A stale snapshot only costs start-up time, so carry on without it.
+        if (snapshotData.has_value()) {
+            Snapshot::activate(*snapshotData);
+        }
+        else {
+            log::warning("Ignoring invalid, outdated or foreign snapshot '" + *cli::options.snapshotPath + "'");
+        }
+    }
 
     if (cli::jitCommand->parsed()) {
         jit::registerCommonActions();
@@ -160,88 +551,61 @@ int main(int argc, char **argv) {
         }
     }
     else if (cli::traceCommand->parsed()) {
-        // TODO: Hard-coded debugging test.
-        ionshared::Ptr<ionir::Args> args = std::make_shared<ionir::Args>();
-        ionshared::Ptr<ionir::VoidType> returnType = std::make_shared<ionir::VoidType>();
-
-        // TODO: Module is nullptr.
-        ionshared::Ptr<ionir::Prototype> prototype =
-            std::make_shared<ionir::Prototype>("foobar", args, returnType, nullptr);
-
-        std::queue<ionshared::Ptr<ionir::Construct>> childrenQueue = {};
-
-        // Push initial child.
-        childrenQueue.push(prototype->nativeCast());
-
-        // TODO: Some kind of depth counter? Currently not working exactly as intended.
-
-        // Begin recursive children iteration.
-        while (!childrenQueue.empty()) {
-            childrenQueue.pop();
+        // Output is streamed through a buffered writer, since it may be huge.
+        llvm::raw_ostream &output = llvm::outs();
+        bool success = true;
 
-            ionshared::Ptr<ionir::Construct> child = childrenQueue.back();
-            ionir::Ast innerChildren = child->getChildrenNodes();
+        cli::options.diagnosticsOnly = true;
 
-            std::cout << "-- "
-                << child->findConstructKindName().value_or("Unknown")
-                << std::endl;
+        for (const auto &inputFilePath : cli::options.inputFilePaths) {
+            std::optional<std::string> input = FileSystem::readFileContents(inputFilePath);
 
-            // Queue inner children if applicable.
-            if (!innerChildren.empty()) {
-                for (const auto innerChild : innerChildren) {
-                    childrenQueue.push(innerChild);
-                }
+            if (!input.has_value()) {
+                log::error("Could not read input file '" + inputFilePath + "'");
+                success = false;
 
-                // TODO: std::cout a newline if this is a terminal node, this way we can stack '--' like a tree?
+                continue;
             }
-        }
-    }
-    else if (!cli::options.inputFilePaths.empty()) {
-        log::verbose("Processing " + std::to_string(cli::options.inputFilePaths.size()) + " input file(s)");
-
-        std::stringstream inputStringStream = std::stringstream();
-        Driver driver = Driver();
-        std::string outputFileExtension = std::string(".") + (cli::options.llvmIr ? "ll" : "o");
 
-        // Create the output directory if it doesn't already exist.
-        if (!std::filesystem::exists(cli::options.out)) {
-            log::verbose("Creating output directory '" + cli::options.out + "'");
+            Driver driver = Driver();
+            std::optional<DriverFrontendResult> frontendResult = driver.runFrontend(*input);
 
-            // Ensure the directory was created, otherwise fail the process.
-            if (!std::filesystem::create_directory(cli::options.out)) {
-                log::error("Output directory could not be created");
+            if (!frontendResult.has_value()) {
+                success = false;
 
-                return EXIT_FAILURE;
+                continue;
             }
-        }
 
-        // TODO: Make target triple be taken in through options, with default to host.
-        llvm::Triple targetTriple = llvm::Triple(llvm::sys::getDefaultTargetTriple());
+            output << "--- " << inputFilePath << ": ionlang AST ---\n";
 
-        bool success = true;
+            AstTracer<ionlang::Construct>(output, !cli::options.traceSummaryOnly)
+                .trace(frontendResult->ionLangModule)
+                .print(output);
 
-        log::verbose("Using target triple: " + targetTriple.getTriple());
+            // Lowering is only available if analysis succeeded.
+            if (ionshared::util::hasValue(frontendResult->ionIrModule)) {
+                output << "--- " << inputFilePath << ": IonIR AST ---\n";
 
-        for (const auto &inputFilePath : cli::options.inputFilePaths) {
-            inputStringStream << std::ifstream(inputFilePath).rdbuf();
-
-            std::filesystem::path outputFilePath =
-                std::filesystem::path(cli::options.out)
-                    .append(inputFilePath)
-                    .concat(outputFileExtension);
-
-            log::verbose("Generating '" + outputFilePath.string() + "'");
-
-            // Stop processing input files if the driver fails to run.
-            if (!driver.run(targetTriple, outputFilePath, inputStringStream.str())) {
+                AstTracer<ionir::Construct>(output, !cli::options.traceSummaryOnly)
+                    .trace(*frontendResult->ionIrModule)
+                    .print(output);
+            }
+            else {
                 success = false;
-
-                break;
             }
+
+            output.flush();
         }
 
         if (!success) {
-            log::error("Generation completed unsuccessfully");
+            return EXIT_FAILURE;
+        }
+    }
+    else if (!cli::options.inputFilePaths.empty()) {
+        BuildSession buildSession = BuildSession(cli::options);
+
+        if (!buildSession.run()) {
+            return EXIT_FAILURE;
         }
     }
     else {
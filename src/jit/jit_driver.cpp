@@ -12,10 +12,13 @@
 #include <ilc/passes/ionlang/ionlang_logger_pass.h>
 #include <ilc/diagnostics/diagnostic_printer.h>
 #include <ilc/misc/log.h>
+#include <ilc/misc/static_init.h>
 #include <ilc/jit/jit_driver.h>
 
 namespace ilc {
     std::vector<ionlang::Token> JitDriver::lex() {
+        StaticInit::ensureInitialized();
+
         ionlang::Lexer lexer = ionlang::Lexer(this->input);
         std::vector<ionlang::Token> tokens = lexer.scan();
 
@@ -21,8 +21,11 @@ namespace ilc {
     }
 
     std::string ConsoleColor::apply(std::string text, ColorKind code) {
-        // TODO: Repeated below.
-        if (cli::options.noColor) {
+        return ConsoleColor::apply(std::move(text), code, !cli::options.noColor);
+    }
+
+    std::string ConsoleColor::apply(std::string text, ColorKind code, bool enabled) {
+        if (!enabled) {
             return text;
         }
 
@@ -30,12 +33,15 @@ namespace ilc {
     }
 
     std::string ConsoleColor::coat(std::string text, ColorKind code) {
-        // TODO: Repeated above.
-        if (cli::options.noColor) {
+        return ConsoleColor::coat(std::move(text), code, !cli::options.noColor);
+    }
+
+    std::string ConsoleColor::coat(std::string text, ColorKind code, bool enabled) {
+        if (!enabled) {
             return text;
         }
 
-        return ConsoleColor::apply(text, code) + ConsoleColor::reset;
+        return ConsoleColor::apply(text, code, true) + ConsoleColor::reset;
     }
 
     std::string ConsoleColor::red(std::string text) {
@@ -0,0 +1,47 @@
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+#include <ilc/misc/exit_report.h>
+
+namespace ilc {
+    namespace {
+        struct ExitReportPrinters {
+            std::mutex mutex;
+
+            std::vector<ExitReportPrinter> printers = {};
+        };
+
+        ExitReportPrinters &getPrinters() {
+            static ExitReportPrinters printers = ExitReportPrinters();
+
+            return printers;
+        }
+
+        void printAtExit() {
+            ExitReportPrinters &printers = getPrinters();
+            std::lock_guard<std::mutex> lock(printers.mutex);
+
+            for (const auto &printer : printers.printers) {
+                printer(llvm::errs());
+            }
+        }
+    }
+
+    void ExitReport::registerPrinter(ExitReportPrinter printer) {
+        static std::once_flag registrationFlag;
+        ExitReportPrinters &printers = getPrinters();
+
+        /**
+         * Construct the printers and the error stream before registering,
+         * so that both are destroyed after the reports are printed.
+         */
+        std::call_once(registrationFlag, [] {
+            llvm::errs();
+            std::atexit(printAtExit);
+        });
+
+        std::lock_guard<std::mutex> lock(printers.mutex);
+
+        printers.printers.push_back(std::move(printer));
+    }
+}
@@ -16,7 +16,8 @@ namespace ilc {
             return std::nullopt;
         }
 
-        std::ifstream stream = std::ifstream(path);
+        // Read as binary, since inputs may also be LLVM bitcode.
+        std::ifstream stream = std::ifstream(path, std::ios::binary);
         std::stringstream buffer;
 
         buffer << stream.rdbuf();
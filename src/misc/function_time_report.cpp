@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/FormatVariadic.h>
+#include <ilc/misc/exit_report.h>
+#include <ilc/misc/function_time_report.h>
+
+namespace ilc {
+    namespace {
+        struct FunctionTimes {
+            std::map<std::string, std::chrono::steady_clock::duration> phases = {};
+
+            std::chrono::steady_clock::duration total = std::chrono::steady_clock::duration::zero();
+
+            std::optional<uint64_t> instructionCount = std::nullopt;
+        };
+
+        std::atomic<bool> enabled = false;
+
+        uint32_t functionLimit = 0;
+
+        std::mutex functionsMutex;
+
+        std::vector<std::string> phaseNames = {};
+
+        std::map<std::string, FunctionTimes> functions = {};
+
+        double toMilliseconds(std::chrono::steady_clock::duration duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        }
+
+        /**
+         * Find the name of the function which the description of a unit
+         * of IR given to a pass gate refers to. Descriptions are of the
+         * form 'function (name)', 'basic block (name) in function (name)'
+         * or 'SCC (name, ...)', among others.
+         */
+        std::optional<std::string> findDescribedFunctionName(llvm::StringRef irDescription) {
+            size_t functionStart = irDescription.find("function (");
+
+            if (functionStart != llvm::StringRef::npos && irDescription.endswith(")")) {
+                return irDescription.slice(functionStart + 10, irDescription.size() - 1).str();
+            }
+            // Only strongly connected components of a single function are attributable.
+            else if (irDescription.startswith("SCC (") && !irDescription.contains(',')) {
+                llvm::StringRef name = irDescription.slice(5, irDescription.size() - 1);
+
+                if (name != "<<null function>>") {
+                    return name.str();
+                }
+            }
+
+            return std::nullopt;
+        }
+    }
+
+    void FunctionTimeReport::enable(uint32_t limit) {
+        enabled = true;
+        functionLimit = limit;
+
+        ExitReport::registerPrinter([](llvm::raw_ostream &output) {
+            FunctionTimeReport::print(output);
+        });
+    }
+
+    bool FunctionTimeReport::isEnabled() noexcept {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void FunctionTimeReport::add(
+        const std::string &functionName,
+        const std::string &phaseName,
+        std::chrono::steady_clock::duration duration
+    ) {
+        std::lock_guard<std::mutex> lock(functionsMutex);
+        FunctionTimes &times = functions[functionName];
+
+        if (std::find(phaseNames.begin(), phaseNames.end(), phaseName) == phaseNames.end()) {
+            phaseNames.push_back(phaseName);
+        }
+
+        times.phases[phaseName] += duration;
+        times.total += duration;
+    }
+
+    void FunctionTimeReport::setInstructionCount(const std::string &functionName, uint64_t count) {
+        std::lock_guard<std::mutex> lock(functionsMutex);
+
+        functions[functionName].instructionCount = count;
+    }
+
+    void FunctionTimeReport::print(llvm::raw_ostream &output) {
+        std::lock_guard<std::mutex> lock(functionsMutex);
+        std::vector<const std::pair<const std::string, FunctionTimes> *> slowestFunctions = {};
+
+        for (const auto &function : functions) {
+            slowestFunctions.push_back(&function);
+        }
+
+        // Slowest first, then by name so that ties print deterministically.
+        std::sort(slowestFunctions.begin(), slowestFunctions.end(), [](const auto *first, const auto *second) {
+            return first->second.total != second->second.total
+                ? first->second.total > second->second.total
+                : first->first < second->first;
+        });
+
+        if (slowestFunctions.size() > functionLimit) {
+            slowestFunctions.resize(functionLimit);
+        }
+
+        output << "Slowest " << slowestFunctions.size() << " of " << functions.size()
+            << " functions (milliseconds):\n";
+
+        output << llvm::left_justify("Function", 32)
+            << " " << llvm::right_justify("Total", 10);
+
+        for (const auto &phaseName : phaseNames) {
+            output << " " << llvm::right_justify(phaseName, std::max<unsigned>(10, phaseName.size()));
+        }
+
+        output << " " << llvm::right_justify("IR instrs", 10) << "\n";
+
+        for (const auto *function : slowestFunctions) {
+            const FunctionTimes &times = function->second;
+
+            output << llvm::left_justify(function->first, 32)
+                << llvm::format(" %10.3f", toMilliseconds(times.total));
+
+            for (const auto &phaseName : phaseNames) {
+                auto phase = times.phases.find(phaseName);
+                unsigned width = std::max<unsigned>(10, phaseName.size());
+
+                if (phase != times.phases.end()) {
+                    output << " " << llvm::right_justify(llvm::formatv("{0:f3}", toMilliseconds(phase->second)).str(), width);
+                }
+                else {
+                    output << " " << llvm::right_justify("-", width);
+                }
+            }
+
+            if (times.instructionCount.has_value()) {
+                output << llvm::format(" %10llu", (unsigned long long)*times.instructionCount);
+            }
+            else {
+                output << " " << llvm::right_justify("n/a", 10);
+            }
+
+            output << "\n";
+        }
+
+        output.flush();
+    }
+
+    FunctionTimer::FunctionTimer(std::string functionName, std::string phaseName) :
+        functionName(std::move(functionName)),
+        phaseName(std::move(phaseName)) {
+        if (FunctionTimeReport::isEnabled()) {
+            this->start = std::chrono::steady_clock::now();
+        }
+    }
+
+    FunctionTimer::~FunctionTimer() {
+        if (this->start.has_value()) {
+            FunctionTimeReport::add(
+                this->functionName,
+                this->phaseName,
+                std::chrono::steady_clock::now() - *this->start
+            );
+        }
+    }
+
+    void FunctionTimingPassGate::switchFunction(std::optional<std::string> nextFunctionName) {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        if (this->functionName.has_value()) {
+            FunctionTimeReport::add(*this->functionName, this->phaseName, now - this->start);
+        }
+
+        this->functionName = std::move(nextFunctionName);
+        this->start = now;
+    }
+
+    FunctionTimingPassGate::FunctionTimingPassGate(llvm::LLVMContext &context, std::string phaseName) :
+        context(context),
+        previousGate(context.getOptPassGate()),
+        phaseName(std::move(phaseName)),
+        start(std::chrono::steady_clock::now()) {
+        context.setOptPassGate(*this);
+    }
+
+    FunctionTimingPassGate::~FunctionTimingPassGate() {
+        this->switchFunction(std::nullopt);
+        this->context.setOptPassGate(this->previousGate);
+    }
+
+    bool FunctionTimingPassGate::isEnabled() const {
+        return true;
+    }
+
+    bool FunctionTimingPassGate::shouldRunPass(const llvm::Pass *pass, llvm::StringRef irDescription) {
+        std::optional<std::string> describedFunctionName = findDescribedFunctionName(irDescription);
+
+        // Loops and regions belong to the function currently worked on.
+        if (describedFunctionName != this->functionName
+            && (describedFunctionName.has_value() || irDescription.startswith("module") || irDescription.startswith("SCC"))) {
+            this->switchFunction(std::move(describedFunctionName));
+        }
+
+        return !this->previousGate.isEnabled() || this->previousGate.shouldRunPass(pass, irDescription);
+    }
+}
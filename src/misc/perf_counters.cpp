@@ -0,0 +1,281 @@
+#include <ilc/cli/cross_platform.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <llvm/Support/Format.h>
+#include <ilc/misc/exit_report.h>
+#include <ilc/misc/log.h>
+#include <ilc/misc/perf_counters.h>
+
+// OS_LINUX covers every Unix, while perf_event_open(2) is specific to Linux.
+#if defined(__linux__)
+    #define ILC_PERF_COUNTERS_AVAILABLE
+
+    #include <linux/perf_event.h>
+    #include <sys/syscall.h>
+#endif
+
+namespace ilc {
+    namespace {
+        struct PhaseTotals {
+            uint64_t calls = 0;
+
+            PerfCounterValues values = {};
+        };
+
+        std::atomic<bool> enabled = false;
+
+        std::mutex phasesMutex;
+
+        std::vector<std::string> phaseNames = {};
+
+        std::map<std::string, PhaseTotals> phases = {};
+
+        std::once_flag unavailableWarningFlag;
+
+        /**
+         * The counters of a single thread, opened upon first use and
+         * closed when the thread exits.
+         */
+        class ThreadCounters {
+        private:
+            std::array<int, perfCounterKindCount> fileDescriptors = {-1, -1, -1, -1};
+
+            bool opened = false;
+
+#if defined(ILC_PERF_COUNTERS_AVAILABLE)
+            static uint64_t findEventConfig(PerfCounterKind kind) {
+                switch (kind) {
+                    case PerfCounterKind::Cycles: {
+                        return PERF_COUNT_HW_CPU_CYCLES;
+                    }
+
+                    case PerfCounterKind::Instructions: {
+                        return PERF_COUNT_HW_INSTRUCTIONS;
+                    }
+
+                    case PerfCounterKind::CacheMisses: {
+                        return PERF_COUNT_HW_CACHE_MISSES;
+                    }
+
+                    default: {
+                        return PERF_COUNT_HW_BRANCH_MISSES;
+                    }
+                }
+            }
+#endif
+
+            void open() {
+                this->opened = true;
+
+#if defined(ILC_PERF_COUNTERS_AVAILABLE)
+                int lastError = 0;
+
+                for (size_t i = 0; i < perfCounterKindCount; i++) {
+                    perf_event_attr attributes = perf_event_attr();
+
+                    std::memset(&attributes, 0, sizeof(attributes));
+                    attributes.size = sizeof(attributes);
+                    attributes.type = PERF_TYPE_HARDWARE;
+                    attributes.config = ThreadCounters::findEventConfig((PerfCounterKind)i);
+
+                    // Scale by these when counters are multiplexed.
+                    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                    // Only user-space counting is permitted to unprivileged processes by default.
+                    attributes.exclude_kernel = 1;
+                    attributes.exclude_hv = 1;
+
+                    // Count the calling thread only, on any CPU.
+                    long fileDescriptor = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+
+                    if (fileDescriptor == -1) {
+                        lastError = errno;
+                    }
+                    else {
+                        this->fileDescriptors[i] = (int)fileDescriptor;
+                    }
+                }
+
+                if (lastError != 0) {
+                    std::call_once(unavailableWarningFlag, [lastError] {
+                        log::warning(
+                            "Some hardware performance counters are unavailable: "
+                                + std::string(std::strerror(lastError))
+                        );
+                    });
+                }
+#else
+                std::call_once(unavailableWarningFlag, [] {
+                    log::warning("Hardware performance counters are only available on Linux");
+                });
+#endif
+            }
+
+        public:
+            ThreadCounters() = default;
+
+            ThreadCounters(const ThreadCounters &) = delete;
+
+            ~ThreadCounters() {
+#if defined(ILC_PERF_COUNTERS_AVAILABLE)
+                for (const auto fileDescriptor : this->fileDescriptors) {
+                    if (fileDescriptor != -1) {
+                        close(fileDescriptor);
+                    }
+                }
+#endif
+            }
+
+            PerfCounterValues read() {
+                if (!this->opened) {
+                    this->open();
+                }
+
+                PerfCounterValues result = {};
+
+#if defined(ILC_PERF_COUNTERS_AVAILABLE)
+                for (size_t i = 0; i < perfCounterKindCount; i++) {
+                    // Value, time enabled and time running.
+                    uint64_t data[3] = {0, 0, 0};
+
+                    if (this->fileDescriptors[i] == -1
+                        || ::read(this->fileDescriptors[i], data, sizeof(data)) != sizeof(data)) {
+                        continue;
+                    }
+
+                    // A counter which never ran cannot be extrapolated.
+                    if (data[2] == 0) {
+                        result[i] = data[1] == 0 ? std::optional<uint64_t>(0) : std::nullopt;
+                    }
+                    else {
+                        result[i] = (uint64_t)((double)data[0] * (double)data[1] / (double)data[2]);
+                    }
+                }
+#endif
+
+                return result;
+            }
+        };
+
+        thread_local ThreadCounters threadCounters;
+
+        void printValue(llvm::raw_ostream &output, const std::optional<uint64_t> &value) {
+            if (value.has_value()) {
+                output << llvm::format("%16llu", (unsigned long long)*value);
+            }
+            else {
+                output << llvm::right_justify("n/a", 16);
+            }
+        }
+    }
+
+    void PerfCounters::enable() {
+        enabled = true;
+
+        ExitReport::registerPrinter([](llvm::raw_ostream &output) {
+            PerfCounters::print(output);
+        });
+    }
+
+    bool PerfCounters::isEnabled() noexcept {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    PerfCounterValues PerfCounters::read() {
+        return threadCounters.read();
+    }
+
+    void PerfCounters::accumulate(
+        const std::string &phaseName,
+        const PerfCounterValues &start,
+        const PerfCounterValues &end
+    ) {
+        std::lock_guard<std::mutex> lock(phasesMutex);
+        auto [phase, inserted] = phases.try_emplace(phaseName);
+
+        if (inserted) {
+            phaseNames.push_back(phaseName);
+
+            // Counters start out as available, and stay so while every reading is.
+            for (auto &value : phase->second.values) {
+                value = 0;
+            }
+        }
+
+        phase->second.calls++;
+
+        for (size_t i = 0; i < perfCounterKindCount; i++) {
+            std::optional<uint64_t> &total = phase->second.values[i];
+
+            if (!total.has_value() || !start[i].has_value() || !end[i].has_value()) {
+                total = std::nullopt;
+            }
+            // Scaled values of multiplexed counters may appear to decrease slightly.
+            else if (*end[i] > *start[i]) {
+                *total += *end[i] - *start[i];
+            }
+        }
+    }
+
+    void PerfCounters::print(llvm::raw_ostream &output) {
+        std::lock_guard<std::mutex> lock(phasesMutex);
+
+        output << llvm::left_justify("Phase", 24)
+            << " " << llvm::right_justify("Calls", 8)
+            << " " << llvm::right_justify("Cycles", 16)
+            << " " << llvm::right_justify("Instructions", 16)
+            << " " << llvm::right_justify("IPC", 8)
+            << " " << llvm::right_justify("Cache misses", 16)
+            << " " << llvm::right_justify("Branch misses", 16)
+            << "\n";
+
+        for (const auto &phaseName : phaseNames) {
+            const PhaseTotals &totals = phases.at(phaseName);
+            const std::optional<uint64_t> &cycles = totals.values[(size_t)PerfCounterKind::Cycles];
+            const std::optional<uint64_t> &instructions = totals.values[(size_t)PerfCounterKind::Instructions];
+
+            output << llvm::left_justify(phaseName, 24)
+                << llvm::format(" %8llu ", (unsigned long long)totals.calls);
+            printValue(output, cycles);
+            output << " ";
+            printValue(output, instructions);
+
+            /**
+             * Instructions per cycle; a low value hints at a phase bound
+             * by memory rather than by computation.
+             */
+            if (cycles.has_value() && instructions.has_value() && *cycles > 0) {
+                output << llvm::format(" %8.2f ", (double)*instructions / (double)*cycles);
+            }
+            else {
+                output << " " << llvm::right_justify("n/a", 8) << " ";
+            }
+
+            printValue(output, totals.values[(size_t)PerfCounterKind::CacheMisses]);
+            output << " ";
+            printValue(output, totals.values[(size_t)PerfCounterKind::BranchMisses]);
+            output << "\n";
+        }
+
+        output.flush();
+    }
+
+    PerfPhase::PerfPhase(std::string phaseName) :
+        phaseName(std::move(phaseName)) {
+        if (PerfCounters::isEnabled()) {
+            this->start = PerfCounters::read();
+        }
+    }
+
+    PerfPhase::~PerfPhase() {
+        if (this->start.has_value()) {
+            PerfCounters::accumulate(this->phaseName, *this->start, PerfCounters::read());
+        }
+    }
+}
@@ -0,0 +1,360 @@
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <mutex>
+#include <llvm/Object/ObjectFile.h>
+#include <llvm/Object/SymbolSize.h>
+#include <llvm/Support/Format.h>
+#include <ilc/misc/exit_report.h>
+#include <ilc/misc/size_report.h>
+
+namespace ilc {
+    namespace {
+        // Pass names under which the relevant remarks are emitted.
+        const llvm::StringRef stackSizePassName = "prologepilog";
+
+        const llvm::StringRef inlinerPassName = "inline";
+
+        struct SizeTotals {
+            uint64_t codeSize = 0;
+
+            uint64_t maxStackSize = 0;
+        };
+
+        std::atomic<bool> enabled = false;
+
+        std::mutex filesMutex;
+
+        std::map<std::string, std::vector<FunctionSize>> files = {};
+
+        SizeTotals findTotals(const std::vector<const FunctionSize *> &functions) {
+            SizeTotals result = SizeTotals();
+
+            for (const auto *function : functions) {
+                result.codeSize += function->codeSize.value_or(0);
+                result.maxStackSize = std::max(result.maxStackSize, function->stackSize.value_or(0));
+            }
+
+            return result;
+        }
+
+        void printJsonSize(llvm::raw_ostream &output, const std::optional<uint64_t> &size) {
+            if (size.has_value()) {
+                output << *size;
+            }
+            else {
+                output << "null";
+            }
+        }
+
+        /**
+         * Enables the remarks which the collector relies upon, besides
+         * those already enabled by the previous handler.
+         */
+        class CollectingDiagnosticHandler : public llvm::DiagnosticHandler {
+        private:
+            SizeReportCollector &collector;
+
+        public:
+            explicit CollectingDiagnosticHandler(SizeReportCollector &collector) :
+                collector(collector) {
+                //
+            }
+
+            bool handleDiagnostics(const llvm::DiagnosticInfo &diagnosticInfo) override {
+                return this->collector.handleDiagnostics(diagnosticInfo);
+            }
+
+            [[nodiscard]] bool isAnalysisRemarkEnabled(llvm::StringRef passName) const override {
+                return passName == stackSizePassName
+                    || this->collector.getPreviousHandler().isAnalysisRemarkEnabled(passName);
+            }
+
+            [[nodiscard]] bool isMissedOptRemarkEnabled(llvm::StringRef passName) const override {
+                return this->collector.getPreviousHandler().isMissedOptRemarkEnabled(passName);
+            }
+
+            [[nodiscard]] bool isPassedOptRemarkEnabled(llvm::StringRef passName) const override {
+                return passName == inlinerPassName
+                    || this->collector.getPreviousHandler().isPassedOptRemarkEnabled(passName);
+            }
+
+            [[nodiscard]] bool isAnyRemarkEnabled() const override {
+                return true;
+            }
+        };
+    }
+
+    void SizeReport::enable(SizeReportFormat format) {
+        enabled = true;
+
+        ExitReport::registerPrinter([format](llvm::raw_ostream &output) {
+            SizeReport::print(output, format);
+        });
+    }
+
+    bool SizeReport::isEnabled() noexcept {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void SizeReport::add(const std::string &sourceFilePath, std::vector<FunctionSize> functions) {
+        std::lock_guard<std::mutex> lock(filesMutex);
+        std::vector<FunctionSize> &fileFunctions = files[sourceFilePath];
+
+        std::move(functions.begin(), functions.end(), std::back_inserter(fileFunctions));
+    }
+
+    std::map<std::string, uint64_t> SizeReport::findCodeSizes(llvm::MemoryBufferRef objectCode) {
+        llvm::Expected<std::unique_ptr<llvm::object::ObjectFile>> objectFile =
+            llvm::object::ObjectFile::createObjectFile(objectCode);
+
+        if (!objectFile) {
+            llvm::consumeError(objectFile.takeError());
+
+            return {};
+        }
+
+        std::map<std::string, uint64_t> result = {};
+
+        for (const auto &[symbol, size] : llvm::object::computeSymbolSizes(**objectFile)) {
+            llvm::Expected<llvm::object::SymbolRef::Type> type = symbol.getType();
+            llvm::Expected<llvm::StringRef> name = symbol.getName();
+
+            if (!type || !name) {
+                llvm::consumeError(type.takeError());
+                llvm::consumeError(name.takeError());
+
+                continue;
+            }
+            else if (*type == llvm::object::SymbolRef::ST_Function) {
+                result[name->str()] = size;
+            }
+        }
+
+        return result;
+    }
+
+    void SizeReport::print(llvm::raw_ostream &output, SizeReportFormat format) {
+        std::lock_guard<std::mutex> lock(filesMutex);
+
+        // Functions of each module of each file, largest first.
+        std::map<std::string, std::map<std::string, std::vector<const FunctionSize *>>> modulesByFile = {};
+
+        for (const auto &[sourceFilePath, functions] : files) {
+            for (const auto &function : functions) {
+                modulesByFile[sourceFilePath][function.moduleName].push_back(&function);
+            }
+        }
+
+        for (auto &[sourceFilePath, modules] : modulesByFile) {
+            for (auto &[moduleName, functions] : modules) {
+                std::sort(functions.begin(), functions.end(), [](const auto *first, const auto *second) {
+                    return first->codeSize != second->codeSize
+                        ? first->codeSize.value_or(0) > second->codeSize.value_or(0)
+                        : first->functionName < second->functionName;
+                });
+            }
+        }
+
+        if (format == SizeReportFormat::Json) {
+            output << "{\n  \"files\": [";
+
+            bool isFirstFile = true;
+
+            for (const auto &[sourceFilePath, modules] : modulesByFile) {
+                std::vector<const FunctionSize *> fileFunctions = {};
+
+                for (const auto &[moduleName, functions] : modules) {
+                    fileFunctions.insert(fileFunctions.end(), functions.begin(), functions.end());
+                }
+
+                SizeTotals fileTotals = findTotals(fileFunctions);
+
+                output << (isFirstFile ? "\n" : ",\n") << "    {\"path\": \"";
+                output.write_escaped(sourceFilePath) << "\", \"codeSize\": " << fileTotals.codeSize
+                    << ", \"maxStackSize\": " << fileTotals.maxStackSize << ", \"modules\": [";
+
+                isFirstFile = false;
+
+                bool isFirstModule = true;
+
+                for (const auto &[moduleName, functions] : modules) {
+                    SizeTotals moduleTotals = findTotals(functions);
+
+                    output << (isFirstModule ? "\n" : ",\n") << "      {\"name\": \"";
+                    output.write_escaped(moduleName) << "\", \"codeSize\": " << moduleTotals.codeSize
+                        << ", \"maxStackSize\": " << moduleTotals.maxStackSize << ", \"functions\": [";
+
+                    isFirstModule = false;
+
+                    bool isFirstFunction = true;
+
+                    for (const auto *function : functions) {
+                        output << (isFirstFunction ? "\n" : ",\n") << "        {\"name\": \"";
+                        output.write_escaped(function->functionName) << "\", \"codeSize\": ";
+                        printJsonSize(output, function->codeSize);
+                        output << ", \"stackSize\": ";
+                        printJsonSize(output, function->stackSize);
+                        output << ", \"inlinedCallees\": [";
+
+                        isFirstFunction = false;
+
+                        for (size_t i = 0; i < function->inlinedCallees.size(); i++) {
+                            output << (i == 0 ? "\"" : ", \"");
+                            output.write_escaped(function->inlinedCallees[i]) << "\"";
+                        }
+
+                        output << "]}";
+                    }
+
+                    output << "\n      ]}";
+                }
+
+                output << "\n    ]}";
+            }
+
+            output << "\n  ]\n}\n";
+            output.flush();
+
+            return;
+        }
+
+        output << "Size report (bytes):\n";
+
+        for (const auto &[sourceFilePath, modules] : modulesByFile) {
+            std::vector<const FunctionSize *> fileFunctions = {};
+
+            for (const auto &[moduleName, functions] : modules) {
+                fileFunctions.insert(fileFunctions.end(), functions.begin(), functions.end());
+            }
+
+            SizeTotals fileTotals = findTotals(fileFunctions);
+
+            output << "\n" << sourceFilePath << ": " << fileTotals.codeSize << " code, "
+                << fileTotals.maxStackSize << " max stack\n";
+
+            for (const auto &[moduleName, functions] : modules) {
+                SizeTotals moduleTotals = findTotals(functions);
+
+                output << "  module " << moduleName << ": " << moduleTotals.codeSize << " code, "
+                    << moduleTotals.maxStackSize << " max stack\n";
+
+                output << "    " << llvm::left_justify("Function", 32)
+                    << " " << llvm::right_justify("Code", 10)
+                    << " " << llvm::right_justify("Stack", 10)
+                    << "  Inlined callees\n";
+
+                for (const auto *function : functions) {
+                    output << "    " << llvm::left_justify(function->functionName, 32) << " "
+                        << llvm::right_justify(function->codeSize.has_value() ? std::to_string(*function->codeSize) : "n/a", 10) << " "
+                        << llvm::right_justify(function->stackSize.has_value() ? std::to_string(*function->stackSize) : "n/a", 10) << "  ";
+
+                    for (size_t i = 0; i < function->inlinedCallees.size(); i++) {
+                        output << (i == 0 ? "" : ", ") << function->inlinedCallees[i];
+                    }
+
+                    output << "\n";
+                }
+            }
+        }
+
+        output.flush();
+    }
+
+    SizeReportCollector::SizeReportCollector(llvm::LLVMContext &context) :
+        context(context),
+        previousHandler(context.getDiagnosticHandler()) {
+        context.setDiagnosticHandler(std::make_unique<CollectingDiagnosticHandler>(*this));
+    }
+
+    SizeReportCollector::~SizeReportCollector() {
+        this->context.setDiagnosticHandler(std::move(this->previousHandler));
+    }
+
+    llvm::DiagnosticHandler &SizeReportCollector::getPreviousHandler() const {
+        return *this->previousHandler;
+    }
+
+    bool SizeReportCollector::handleDiagnostics(const llvm::DiagnosticInfo &diagnosticInfo) {
+        const auto *remark = llvm::dyn_cast<llvm::DiagnosticInfoOptimizationBase>(&diagnosticInfo);
+
+        if (remark != nullptr) {
+            llvm::StringRef passName = llvm::StringRef(remark->getPassName());
+            bool isStackSize = passName == stackSizePassName && remark->getRemarkName() == "StackSize";
+            bool isInlining = passName == inlinerPassName && remark->getRemarkName() == "Inlined";
+
+            if (isStackSize || isInlining) {
+                std::string functionName = remark->getFunction().getName().str();
+
+                for (const auto &argument : remark->getArgs()) {
+                    uint64_t stackSize;
+
+                    if (isStackSize && argument.Key == "NumStackBytes"
+                        && !llvm::StringRef(argument.Val).getAsInteger(10, stackSize)) {
+                        this->stackSizes[functionName] = stackSize;
+                    }
+                    else if (isInlining && argument.Key == "Callee") {
+                        std::vector<std::string> &callees = this->inlinedCallees[functionName];
+
+                        if (std::find(callees.begin(), callees.end(), argument.Val) == callees.end()) {
+                            callees.push_back(argument.Val);
+                        }
+                    }
+                }
+
+                // Remarks only enabled for the report are not the previous handler's concern.
+                bool isRequested = isStackSize
+                    ? this->previousHandler->isAnalysisRemarkEnabled(passName)
+                    : this->previousHandler->isPassedOptRemarkEnabled(passName);
+
+                if (!isRequested) {
+                    return true;
+                }
+            }
+        }
+
+        return this->previousHandler->handleDiagnostics(diagnosticInfo);
+    }
+
+    std::vector<FunctionSize> SizeReportCollector::collect(
+        const llvm::Module &module,
+        const llvm::MemoryBuffer *objectCode
+    ) const {
+        std::map<std::string, uint64_t> codeSizes = objectCode != nullptr
+            ? SizeReport::findCodeSizes(objectCode->getMemBufferRef())
+            : std::map<std::string, uint64_t>();
+
+        std::vector<FunctionSize> result = {};
+
+        for (const auto &function : module) {
+            if (function.isDeclaration()) {
+                continue;
+            }
+
+            std::string functionName = function.getName().str();
+            FunctionSize functionSize = FunctionSize{module.getSourceFileName(), functionName};
+            auto codeSize = codeSizes.find(functionName);
+
+            // Mach-O prefixes symbol names with an underscore.
+            if (codeSize == codeSizes.end()) {
+                codeSize = codeSizes.find("_" + functionName);
+            }
+
+            if (codeSize != codeSizes.end()) {
+                functionSize.codeSize = codeSize->second;
+            }
+
+            if (auto stackSize = this->stackSizes.find(functionName); stackSize != this->stackSizes.end()) {
+                functionSize.stackSize = stackSize->second;
+            }
+
+            if (auto callees = this->inlinedCallees.find(functionName); callees != this->inlinedCallees.end()) {
+                functionSize.inlinedCallees = callees->second;
+            }
+
+            result.push_back(std::move(functionSize));
+        }
+
+        return result;
+    }
+}
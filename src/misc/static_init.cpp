@@ -0,0 +1,13 @@
+#include <mutex>
+#include <ionlang/misc/static_init.h>
+#include <ilc/misc/static_init.h>
+
+namespace ilc {
+    void StaticInit::ensureInitialized() {
+        static std::once_flag initializedFlag;
+
+        std::call_once(initializedFlag, [] {
+            ionlang::static_init::init();
+        });
+    }
+}
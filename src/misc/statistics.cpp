@@ -0,0 +1,217 @@
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <llvm/ADT/Statistic.h>
+#include <llvm/Support/Format.h>
+#include <ilc/misc/exit_report.h>
+#include <ilc/misc/statistics.h>
+
+namespace ilc {
+    namespace {
+        std::atomic<bool> enabled = false;
+
+        std::array<std::atomic<uint64_t>, (size_t)Statistic::Count> slots = {};
+
+        struct GlobalCounters {
+            std::mutex mutex;
+
+            std::map<std::string, uint64_t> counters = {};
+        };
+
+        GlobalCounters &getGlobalCounters() {
+            static GlobalCounters globalCounters = GlobalCounters();
+
+            return globalCounters;
+        }
+
+        void merge(std::map<std::string, uint64_t> &target, const std::map<std::string, uint64_t> &source) {
+            for (const auto &[name, value] : source) {
+                target[name] += value;
+            }
+        }
+
+        /**
+         * Whether the counters of the calling thread were already merged.
+         * The main thread's are destroyed before statistics are printed
+         * upon exit, and must not be accessed anymore by then.
+         */
+        thread_local bool localCountersMerged = false;
+
+        /**
+         * Counters of a single thread, merged into the global counters
+         * when the thread exits.
+         */
+        struct LocalCounters {
+            std::map<std::string, uint64_t> counters = {};
+
+            ~LocalCounters() {
+                GlobalCounters &globalCounters = getGlobalCounters();
+                std::lock_guard<std::mutex> lock(globalCounters.mutex);
+
+                merge(globalCounters.counters, this->counters);
+                localCountersMerged = true;
+            }
+        };
+
+        thread_local LocalCounters localCounters = LocalCounters();
+    }
+
+    void Statistics::enable(StatisticsFormat format) {
+        enabled = true;
+
+        // Count LLVM's statistics too, if it was built with them.
+        llvm::EnableStatistics(false);
+
+        /**
+         * Construct the global counters first, so that they are destroyed
+         * after statistics are printed upon exit.
+         */
+        getGlobalCounters();
+
+        ExitReport::registerPrinter([format](llvm::raw_ostream &output) {
+            Statistics::print(output, format);
+        });
+    }
+
+    bool Statistics::isEnabled() noexcept {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    std::string Statistics::findName(Statistic statistic) {
+        switch (statistic) {
+            case Statistic::LexerTokens: {
+                return "lexer.tokens";
+            }
+
+            case Statistic::IonIrFunctions: {
+                return "ionir.functions";
+            }
+
+            case Statistic::IonIrBasicBlocks: {
+                return "ionir.basic-blocks";
+            }
+
+            case Statistic::IonIrInstructions: {
+                return "ionir.instructions";
+            }
+
+            case Statistic::IonIrBranchesFolded: {
+                return "ionir-optimization.branches-folded";
+            }
+
+            case Statistic::IonIrUnreachableBlocksRemoved: {
+                return "ionir-optimization.unreachable-blocks-removed";
+            }
+
+            case Statistic::IonIrDeadInstructionsRemoved: {
+                return "ionir-optimization.dead-instructions-removed";
+            }
+
+            case Statistic::IonIrDeadFunctionsStripped: {
+                return "ionir-optimization.dead-functions-stripped";
+            }
+
+            case Statistic::LlvmIrFunctions: {
+                return "llvm-ir.functions";
+            }
+
+            case Statistic::LlvmIrBasicBlocks: {
+                return "llvm-ir.basic-blocks";
+            }
+
+            case Statistic::LlvmIrInstructions: {
+                return "llvm-ir.instructions";
+            }
+
+            case Statistic::CodegenBytesEmitted: {
+                return "codegen.bytes-emitted";
+            }
+
+            case Statistic::IonLangLoggerVisits: {
+                return "logger-pass.ionlang.visits";
+            }
+
+            case Statistic::IonIrLoggerVisits: {
+                return "logger-pass.ionir.visits";
+            }
+
+            default: {
+                return "unknown";
+            }
+        }
+    }
+
+    void Statistics::add(Statistic statistic, uint64_t amount) {
+        if (!Statistics::isEnabled()) {
+            return;
+        }
+
+        slots[(size_t)statistic].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void Statistics::add(const std::string &group, const std::string &name, uint64_t amount) {
+        if (!Statistics::isEnabled() || localCountersMerged) {
+            return;
+        }
+
+        localCounters.counters[group + "." + name] += amount;
+    }
+
+    std::map<std::string, uint64_t> Statistics::collect() {
+        GlobalCounters &globalCounters = getGlobalCounters();
+        std::map<std::string, uint64_t> result = {};
+
+        {
+            std::lock_guard<std::mutex> lock(globalCounters.mutex);
+
+            result = globalCounters.counters;
+        }
+
+        if (!localCountersMerged) {
+            merge(result, localCounters.counters);
+        }
+
+        for (size_t slot = 0; slot < slots.size(); slot++) {
+            uint64_t value = slots[slot].load(std::memory_order_relaxed);
+
+            if (value != 0) {
+                result[Statistics::findName((Statistic)slot)] += value;
+            }
+        }
+
+        for (const auto &[name, value] : llvm::GetStatistics()) {
+            result["llvm." + name.str()] += value;
+        }
+
+        return result;
+    }
+
+    void Statistics::print(llvm::raw_ostream &output, StatisticsFormat format) {
+        std::map<std::string, uint64_t> statistics = Statistics::collect();
+
+        if (format == StatisticsFormat::Json) {
+            output << "{";
+
+            bool isFirst = true;
+
+            for (const auto &[name, value] : statistics) {
+                output << (isFirst ? "\n" : ",\n") << "  \"";
+                output.write_escaped(name) << "\": " << value;
+                isFirst = false;
+            }
+
+            output << "\n}\n";
+        }
+        else {
+            output << "===" << std::string(73, '-') << "===\n"
+                << "                          ... Statistics Collected ...\n"
+                << "===" << std::string(73, '-') << "===\n\n";
+
+            for (const auto &[name, value] : statistics) {
+                output << llvm::format("%12llu %s\n", (unsigned long long)value, name.c_str());
+            }
+        }
+
+        output.flush();
+    }
+}
@@ -0,0 +1,121 @@
+#include <ilc/misc/thread_pool.h>
+
+namespace ilc {
+    namespace {
+        thread_local uint32_t nestedThreadCount = 0;
+    }
+
+    void ThreadPool::work() {
+        nestedThreadCount = this->nestedThreadCount;
+
+        while (true) {
+            ThreadPoolTask task;
+
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+
+                this->taskAvailable.wait(lock, [this] {
+                    return this->stopping || !this->tasks.empty();
+                });
+
+                // Only exit once the queue has been drained.
+                if (this->tasks.empty()) {
+                    return;
+                }
+
+                task = std::move(this->tasks.front());
+                this->tasks.pop();
+            }
+
+            std::exception_ptr exception = nullptr;
+
+            try {
+                task();
+            }
+            catch (...) {
+                exception = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(this->mutex);
+
+            // Retain only the first failure; it is re-thrown upon waiting.
+            if (exception != nullptr && this->exception == nullptr) {
+                this->exception = exception;
+            }
+
+            this->pendingTasks--;
+
+            if (this->pendingTasks == 0) {
+                this->idle.notify_all();
+            }
+        }
+    }
+
+    uint32_t ThreadPool::resolveThreadCount(uint32_t threadCount) {
+        if (threadCount != 0) {
+            return threadCount;
+        }
+
+        // May return zero if the value is not computable.
+        uint32_t hardwareThreadCount = std::thread::hardware_concurrency();
+
+        return hardwareThreadCount == 0 ? 1 : hardwareThreadCount;
+    }
+
+    uint32_t ThreadPool::findNestedThreadCount() noexcept {
+        return nestedThreadCount;
+    }
+
+    ThreadPool::ThreadPool(uint32_t threadCount, uint32_t nestedThreadCount) :
+        nestedThreadCount(nestedThreadCount) {
+        threadCount = ThreadPool::resolveThreadCount(threadCount);
+
+        for (uint32_t i = 0; i < threadCount; i++) {
+            this->workers.emplace_back(&ThreadPool::work, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+
+            this->stopping = true;
+        }
+
+        this->taskAvailable.notify_all();
+
+        for (auto &worker : this->workers) {
+            worker.join();
+        }
+    }
+
+    uint32_t ThreadPool::getThreadCount() const noexcept {
+        return this->workers.size();
+    }
+
+    void ThreadPool::submit(ThreadPoolTask task) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+
+            this->tasks.push(std::move(task));
+            this->pendingTasks++;
+        }
+
+        this->taskAvailable.notify_one();
+    }
+
+    void ThreadPool::wait() {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        this->idle.wait(lock, [this] {
+            return this->pendingTasks == 0;
+        });
+
+        if (this->exception != nullptr) {
+            std::exception_ptr exception = this->exception;
+
+            this->exception = nullptr;
+            std::rethrow_exception(exception);
+        }
+    }
+}
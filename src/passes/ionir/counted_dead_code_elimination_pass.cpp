@@ -0,0 +1,41 @@
+#include <ilc/passes/ionir/counted_dead_code_elimination_pass.h>
+#include <ilc/misc/statistics.h>
+#include <ionir/construct/function.h>
+#include <ionir/construct/basic_block.h>
+
+namespace ilc {
+    size_t CountedDeadCodeEliminationPass::findInstructionCount(const ionshared::Ptr<ionir::Function> &function) {
+        size_t count = 0;
+
+        for (const auto &[name, basicBlock] : function->body->getSymbolTable()->unwrap()) {
+            count += basicBlock->instructions.size();
+        }
+
+        return count;
+    }
+
+    CountedDeadCodeEliminationPass::CountedDeadCodeEliminationPass(
+        ionshared::Ptr<ionshared::PassContext> context
+    ) :
+        ionir::DeadCodeEliminationPass(std::move(context)) {
+        //
+    }
+
+    void CountedDeadCodeEliminationPass::visitFunction(ionshared::Ptr<ionir::Function> node) {
+        if (!Statistics::isEnabled()) {
+            ionir::DeadCodeEliminationPass::visitFunction(node);
+
+            return;
+        }
+
+        size_t countBefore = CountedDeadCodeEliminationPass::findInstructionCount(node);
+
+        ionir::DeadCodeEliminationPass::visitFunction(node);
+
+        size_t countAfter = CountedDeadCodeEliminationPass::findInstructionCount(node);
+
+        if (countBefore > countAfter) {
+            Statistics::add(Statistic::IonIrDeadInstructionsRemoved, countBefore - countAfter);
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#include <ilc/passes/ionir/ionir_constant_folding_pass.h>
+#include <ilc/misc/statistics.h>
+#include <ionir/construct/basic_block.h>
+#include <ionir/construct/inst/branch.h>
+#include <ionir/construct/value/boolean_literal.h>
+
+namespace ilc {
+    IonIrConstantFoldingPass::IonIrConstantFoldingPass(
+        ionshared::Ptr<ionshared::PassContext> context
+    ) :
+        ionir::Pass(std::move(context)) {
+        //
+    }
+
+    void IonIrConstantFoldingPass::visitBasicBlock(ionshared::Ptr<ionir::BasicBlock> node) {
+        for (const auto &instruction : node->instructions) {
+            ionshared::Ptr<ionir::BranchInst> branchInst =
+                std::dynamic_pointer_cast<ionir::BranchInst>(instruction);
+
+            if (branchInst == nullptr) {
+                continue;
+            }
+
+            ionshared::Ptr<ionir::BooleanLiteral> condition =
+                std::dynamic_pointer_cast<ionir::BooleanLiteral>(branchInst->condition);
+
+            // Already folded, or not known until run-time.
+            if (condition == nullptr || branchInst->consequentBasicBlock == branchInst->alternativeBasicBlock) {
+                continue;
+            }
+
+            if (condition->value) {
+                branchInst->alternativeBasicBlock = branchInst->consequentBasicBlock;
+            }
+            else {
+                branchInst->consequentBasicBlock = branchInst->alternativeBasicBlock;
+            }
+
+            Statistics::add(Statistic::IonIrBranchesFolded);
+        }
+
+        ionir::Pass::visitBasicBlock(node);
+    }
+}
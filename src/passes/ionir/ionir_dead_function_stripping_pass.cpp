@@ -0,0 +1,74 @@
+#include <set>
+#include <vector>
+#include <ilc/passes/ionir/ionir_dead_function_stripping_pass.h>
+#include <ilc/misc/statistics.h>
+#include <ilc/misc/util.h>
+#include <ionir/construct/module.h>
+#include <ionir/construct/function.h>
+#include <ionir/construct/basic_block.h>
+#include <ionir/construct/inst/call.h>
+
+namespace ilc {
+    IonIrDeadFunctionStrippingPass::IonIrDeadFunctionStrippingPass(
+        ionshared::Ptr<ionshared::PassContext> context
+    ) :
+        ionir::Pass(std::move(context)) {
+        //
+    }
+
+    void IonIrDeadFunctionStrippingPass::visitModule(ionshared::Ptr<ionir::Module> node) {
+        ionshared::OptPtr<ionir::Function> entryPoint = node->lookupFunction(ILC_IONIR_ENTRY_POINT_NAME);
+
+        if (!Util::hasValue(entryPoint)) {
+            ionir::Pass::visitModule(node);
+
+            return;
+        }
+
+        std::set<ionir::Function *> reachable = {};
+        std::vector<ionshared::Ptr<ionir::Function>> worklist = {*entryPoint};
+
+        while (!worklist.empty()) {
+            ionshared::Ptr<ionir::Function> function = worklist.back();
+
+            worklist.pop_back();
+
+            if (!reachable.insert(function.get()).second) {
+                continue;
+            }
+
+            for (const auto &[name, basicBlock] : function->body->getSymbolTable()->unwrap()) {
+                for (const auto &instruction : basicBlock->instructions) {
+                    ionshared::Ptr<ionir::CallInst> callInst =
+                        std::dynamic_pointer_cast<ionir::CallInst>(instruction);
+
+                    // Calls to externs have no body to follow.
+                    if (callInst == nullptr) {
+                        continue;
+                    }
+                    else if (auto callee = std::dynamic_pointer_cast<ionir::Function>(callInst->callee)) {
+                        worklist.push_back(callee);
+                    }
+                }
+            }
+        }
+
+        auto globalScope = node->context->getGlobalScope();
+        std::vector<std::string> unreachableNames = {};
+
+        for (const auto &[name, construct] : globalScope->unwrap()) {
+            if (construct->constructKind == ionir::ConstructKind::Function
+                && !reachable.contains(static_cast<ionir::Function *>(construct.get()))) {
+                unreachableNames.push_back(name);
+            }
+        }
+
+        for (const auto &name : unreachableNames) {
+            globalScope->remove(name);
+        }
+
+        Statistics::add(Statistic::IonIrDeadFunctionsStripped, unreachableNames.size());
+
+        ionir::Pass::visitModule(node);
+    }
+}
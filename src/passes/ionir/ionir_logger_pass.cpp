@@ -1,6 +1,7 @@
 #include <iostream>
 #include <ilc/passes/ionir/ionir_logger_pass.h>
 #include <ilc/misc/log.h>
+#include <ilc/misc/statistics.h>
 #include <ionir/const/const.h>
 
 namespace ilc {
@@ -20,7 +21,9 @@ namespace ilc {
         std::cout << "Visiting: "
             << constructName.value_or(defaultName)
             << addressString
-            << std::endl;
+            << '\n';
+
+        Statistics::add(Statistic::IonIrLoggerVisits);
 
         ionir::Pass::visit(node);
     }
@@ -0,0 +1,84 @@
+#include <set>
+#include <ilc/passes/ionir/ionir_unreachable_block_removal_pass.h>
+#include <ilc/misc/statistics.h>
+#include <ionir/construct/function.h>
+#include <ionir/construct/basic_block.h>
+#include <ionir/construct/inst/branch.h>
+#include <ionir/construct/inst/jump.h>
+
+namespace ilc {
+    std::vector<ionshared::Ptr<ionir::BasicBlock>> IonIrUnreachableBlockRemovalPass::findSuccessors(
+        const ionshared::Ptr<ionir::BasicBlock> &basicBlock
+    ) {
+        std::vector<ionshared::Ptr<ionir::BasicBlock>> successors = {};
+
+        for (const auto &instruction : basicBlock->instructions) {
+            if (auto branchInst = std::dynamic_pointer_cast<ionir::BranchInst>(instruction)) {
+                successors.push_back(branchInst->consequentBasicBlock);
+                successors.push_back(branchInst->alternativeBasicBlock);
+            }
+            else if (auto jumpInst = std::dynamic_pointer_cast<ionir::JumpInst>(instruction)) {
+                successors.push_back(jumpInst->basicBlockTarget);
+            }
+        }
+
+        return successors;
+    }
+
+    IonIrUnreachableBlockRemovalPass::IonIrUnreachableBlockRemovalPass(
+        ionshared::Ptr<ionshared::PassContext> context
+    ) :
+        ionir::Pass(std::move(context)) {
+        //
+    }
+
+    void IonIrUnreachableBlockRemovalPass::visitFunction(ionshared::Ptr<ionir::Function> node) {
+        auto basicBlocks = node->body->getSymbolTable();
+        std::set<ionir::BasicBlock *> reachable = {};
+        std::vector<ionshared::Ptr<ionir::BasicBlock>> worklist = {};
+
+        for (const auto &[name, basicBlock] : basicBlocks->unwrap()) {
+            if (basicBlock->basicBlockKind == ionir::BasicBlockKind::Entry) {
+                worklist.push_back(basicBlock);
+            }
+        }
+
+        // Without an entry block, there is nothing to measure reachability from.
+        if (worklist.empty()) {
+            ionir::Pass::visitFunction(node);
+
+            return;
+        }
+
+        while (!worklist.empty()) {
+            ionshared::Ptr<ionir::BasicBlock> basicBlock = worklist.back();
+
+            worklist.pop_back();
+
+            if (basicBlock == nullptr || !reachable.insert(basicBlock.get()).second) {
+                continue;
+            }
+
+            for (const auto &successor : IonIrUnreachableBlockRemovalPass::findSuccessors(basicBlock)) {
+                worklist.push_back(successor);
+            }
+        }
+
+        std::vector<std::string> unreachableNames = {};
+
+        for (const auto &[name, basicBlock] : basicBlocks->unwrap()) {
+            if (!reachable.contains(basicBlock.get())) {
+                unreachableNames.push_back(name);
+            }
+        }
+
+        for (const auto &name : unreachableNames) {
+            basicBlocks->remove(name);
+        }
+
+        Statistics::add(Statistic::IonIrUnreachableBlocksRemoved, unreachableNames.size());
+
+        // Only visit the blocks which remain.
+        ionir::Pass::visitFunction(node);
+    }
+}
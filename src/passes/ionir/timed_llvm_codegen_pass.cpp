@@ -0,0 +1,17 @@
+#include <ilc/passes/ionir/timed_llvm_codegen_pass.h>
+#include <ilc/misc/function_time_report.h>
+
+namespace ilc {
+    TimedLlvmCodegenPass::TimedLlvmCodegenPass(
+        ionshared::Ptr<ionshared::PassContext> context
+    ) :
+        ionir::LlvmCodegenPass(std::move(context)) {
+        //
+    }
+
+    void TimedLlvmCodegenPass::visitFunction(ionshared::Ptr<ionir::Function> node) {
+        FunctionTimer functionTimer = FunctionTimer(node->prototype->name, "llvm-lowering");
+
+        ionir::LlvmCodegenPass::visitFunction(node);
+    }
+}
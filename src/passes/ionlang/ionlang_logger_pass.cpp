@@ -1,12 +1,15 @@
 #include <ionlang/const/const.h>
 #include <ilc/passes/ionlang/ionlang_logger_pass.h>
 #include <ilc/misc/log.h>
+#include <ilc/misc/statistics.h>
 
 namespace ilc {
     IonLangLoggerPass::IonLangLoggerPass(
-        ionshared::Ptr<ionshared::PassContext> context
+        ionshared::Ptr<ionshared::PassContext> context,
+        std::function<void(const std::string &text)> output
     ) :
-        ionlang::Pass(std::move(context)) {
+        ionlang::Pass(std::move(context)),
+        output(std::move(output)) {
         //
     }
 
@@ -16,10 +19,16 @@ namespace ilc {
         std::string defaultName = "Unknown (" + std::to_string((int)constructKind) + ")";
         std::string addressString = " [" + ionshared::util::getPointerAddressString(node.get()) + "]";
 
-        std::cout << "Visiting: "
-            << constructName.value_or(defaultName)
-            << addressString
-            << std::endl;
+        std::string line = "Visiting: " + constructName.value_or(defaultName) + addressString + '\n';
+
+        if (this->output != nullptr) {
+            this->output(line);
+        }
+        else {
+            std::cout << line;
+        }
+
+        Statistics::add(Statistic::IonLangLoggerVisits);
 
         // TODO: Causing weak_ptr from this->shared_from_this() error.
         ionlang::Pass::visit(node);
@@ -0,0 +1,17 @@
+#include <ilc/passes/ionlang/timed_ionir_lowering_pass.h>
+#include <ilc/misc/function_time_report.h>
+
+namespace ilc {
+    TimedIonIrLoweringPass::TimedIonIrLoweringPass(
+        ionshared::Ptr<ionshared::PassContext> context
+    ) :
+        ionlang::IonIrLoweringPass(std::move(context)) {
+        //
+    }
+
+    void TimedIonIrLoweringPass::visitFunction(ionshared::Ptr<ionlang::Function> node) {
+        FunctionTimer functionTimer = FunctionTimer(node->prototype->name, "ionir-lowering");
+
+        ionlang::IonIrLoweringPass::visitFunction(node);
+    }
+}
@@ -0,0 +1,82 @@
+#include <filesystem>
+#include <set>
+#include <llvm/Object/ArchiveWriter.h>
+#include <ilc/misc/log.h>
+#include <ilc/processing/archiver.h>
+
+namespace ilc {
+    std::vector<std::string> Archiver::findUniqueMemberNames(const std::vector<std::string> &memberNames) {
+        std::vector<std::string> result = {};
+        std::set<std::string> takenNames = std::set<std::string>(memberNames.begin(), memberNames.end());
+        std::set<std::string> usedNames = {};
+
+        for (const auto &memberName : memberNames) {
+            std::filesystem::path memberPath = std::filesystem::path(memberName);
+            std::string uniqueName = memberName;
+
+            /**
+             * Suffix the stem, so that the extension stays recognizable,
+             * skipping names which later members use as-is.
+             */
+            for (size_t suffix = 1;
+                usedNames.contains(uniqueName) || (uniqueName != memberName && takenNames.contains(uniqueName));
+                suffix++) {
+                uniqueName = memberPath.stem().string() + "." + std::to_string(suffix) + memberPath.extension().string();
+            }
+
+            usedNames.insert(uniqueName);
+            result.push_back(uniqueName);
+        }
+
+        return result;
+    }
+
+    Archiver::Archiver(ArchiverOpts opts) :
+        opts(std::move(opts)) {
+        //
+    }
+
+    bool Archiver::archive(
+        const std::vector<std::unique_ptr<llvm::MemoryBuffer>> &objects,
+        const std::vector<std::string> &memberNames
+    ) {
+        if (objects.size() != memberNames.size()) {
+            log::error("Archive member names do not match the objects to archive");
+
+            return false;
+        }
+
+        std::vector<llvm::NewArchiveMember> members = {};
+        std::vector<std::string> uniqueMemberNames = Archiver::findUniqueMemberNames(memberNames);
+
+        // Members refer to the objects' buffers rather than copying them.
+        for (size_t i = 0; i < objects.size(); i++) {
+            llvm::NewArchiveMember member = llvm::NewArchiveMember(objects[i]->getMemBufferRef());
+
+            member.MemberName = uniqueMemberNames[i];
+            members.push_back(std::move(member));
+        }
+
+        llvm::object::Archive::Kind kind = this->opts.targetTriple.isOSDarwin()
+            ? llvm::object::Archive::K_DARWIN
+            : llvm::object::Archive::K_GNU;
+
+        // Deterministic, so that unchanged inputs produce identical archives.
+        llvm::Error error = llvm::writeArchive(
+            this->opts.outputFilePath.string(),
+            members,
+            true,
+            kind,
+            true,
+            false
+        );
+
+        if (error) {
+            log::error("Could not write archive: " + llvm::toString(std::move(error)));
+
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,164 @@
+#include <cstring>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SHA1.h>
+#include <ilc/cli/options.h>
+#include <ilc/misc/const.h>
+#include <ilc/processing/ast_cache.h>
+
+#define ILC_AST_CACHE_EXTENSION ".ast"
+
+#define ILC_AST_CACHE_MAGIC "ILCAST\0\0"
+
+#define ILC_AST_CACHE_MAGIC_SIZE 8
+
+/**
+ * Bump whenever the lowered representation, or the layout of cache
+ * files changes, to invalidate existing caches.
+ */
+#define ILC_AST_CACHE_SCHEMA_VERSION 1
+
+// Size of a SHA-1 digest.
+#define ILC_AST_CACHE_HASH_SIZE 20
+
+namespace ilc {
+    namespace {
+        /**
+         * Sized to a multiple of four bytes, since LLVM requires the
+         * bitcode following it to be 32-bit aligned.
+         */
+        struct AstCacheHeader {
+            char magic[ILC_AST_CACHE_MAGIC_SIZE];
+
+            uint32_t schemaVersion;
+
+            char contentHash[ILC_AST_CACHE_HASH_SIZE];
+        };
+
+        static_assert(sizeof(AstCacheHeader) % 4 == 0);
+    }
+
+    std::filesystem::path AstCache::makePath(const std::filesystem::path &outputFilePath) {
+        return std::filesystem::path(outputFilePath).concat(ILC_AST_CACHE_EXTENSION);
+    }
+
+    std::string AstCache::findContentHash(
+        const std::string &input,
+        const llvm::Triple &targetTriple,
+        const std::set<cli::PassKind> &passes,
+        bool optimizesIonIr
+    ) {
+        llvm::SHA1 hasher = llvm::SHA1();
+
+        // Either version may lower the same input differently.
+        hasher.update(ILC_CLI_VERSION ";" LLVM_VERSION_STRING ";");
+        hasher.update(targetTriple.getTriple());
+
+        // Enabled passes affect which diagnostics are reported, and thereby whether lowering succeeds.
+        for (const auto pass : passes) {
+            hasher.update(std::to_string((int)pass) + ",");
+        }
+
+        // Optimization of the IonIR module changes the resulting LLVM module.
+        hasher.update(optimizesIonIr ? ";opt;" : ";");
+        hasher.update(input);
+
+        return hasher.final().str();
+    }
+
+    std::unique_ptr<llvm::Module> AstCache::load(
+        const std::filesystem::path &cacheFilePath,
+        const std::string &contentHash,
+        llvm::LLVMContext &context
+    ) {
+        llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> cacheFile =
+            llvm::MemoryBuffer::getFile(cacheFilePath.string(), -1, false);
+
+        if (!cacheFile || (*cacheFile)->getBufferSize() <= sizeof(AstCacheHeader)) {
+            return nullptr;
+        }
+
+        AstCacheHeader header;
+
+        std::memcpy(&header, (*cacheFile)->getBufferStart(), sizeof(AstCacheHeader));
+
+        bool isValid = std::memcmp(header.magic, ILC_AST_CACHE_MAGIC, ILC_AST_CACHE_MAGIC_SIZE) == 0
+            && header.schemaVersion == ILC_AST_CACHE_SCHEMA_VERSION
+            && contentHash.size() == ILC_AST_CACHE_HASH_SIZE
+            && std::memcmp(header.contentHash, contentHash.data(), ILC_AST_CACHE_HASH_SIZE) == 0;
+
+        if (!isValid) {
+            return nullptr;
+        }
+
+        llvm::MemoryBufferRef bitcode = llvm::MemoryBufferRef(
+            (*cacheFile)->getBuffer().drop_front(sizeof(AstCacheHeader)),
+            cacheFilePath.string()
+        );
+
+        llvm::Expected<std::unique_ptr<llvm::Module>> module = llvm::parseBitcodeFile(bitcode, context);
+
+        // Corrupt caches are simply ignored, and overwritten later on.
+        if (!module) {
+            llvm::consumeError(module.takeError());
+
+            return nullptr;
+        }
+
+        return std::move(*module);
+    }
+
+    bool AstCache::store(
+        const std::filesystem::path &cacheFilePath,
+        const std::string &contentHash,
+        const llvm::Module &module
+    ) {
+        if (contentHash.size() != ILC_AST_CACHE_HASH_SIZE) {
+            return false;
+        }
+
+        std::error_code errorCode = std::error_code();
+
+        std::filesystem::create_directories(cacheFilePath.parent_path(), errorCode);
+
+        AstCacheHeader header = AstCacheHeader();
+
+        std::memcpy(header.magic, ILC_AST_CACHE_MAGIC, ILC_AST_CACHE_MAGIC_SIZE);
+        header.schemaVersion = ILC_AST_CACHE_SCHEMA_VERSION;
+        std::memcpy(header.contentHash, contentHash.data(), ILC_AST_CACHE_HASH_SIZE);
+
+        int fileDescriptor;
+        llvm::SmallString<128> temporaryFilePath;
+
+        if (llvm::sys::fs::createUniqueFile(cacheFilePath.string() + ".tmp-%%%%%%%%", fileDescriptor, temporaryFilePath)) {
+            return false;
+        }
+
+        {
+            llvm::raw_fd_ostream temporaryFileStream = llvm::raw_fd_ostream(fileDescriptor, true);
+
+            temporaryFileStream.write(reinterpret_cast<const char *>(&header), sizeof(AstCacheHeader));
+            llvm::WriteBitcodeToFile(module, temporaryFileStream);
+            temporaryFileStream.flush();
+
+            if (temporaryFileStream.has_error()) {
+                temporaryFileStream.clear_error();
+                llvm::sys::fs::remove(temporaryFilePath);
+
+                return false;
+            }
+        }
+
+        // Readers never observe a partially written cache file.
+        if (llvm::sys::fs::rename(temporaryFilePath, cacheFilePath.string())) {
+            llvm::sys::fs::remove(temporaryFilePath);
+
+            return false;
+        }
+
+        return true;
+    }
+}
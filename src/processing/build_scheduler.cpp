@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <mutex>
+#include <ilc/misc/thread_pool.h>
+#include <ilc/processing/build_scheduler.h>
+
+namespace ilc {
+    BuildScheduler::BuildScheduler(const DependencyGraph &graph, uint32_t jobs) :
+        graph(graph),
+        jobs(ThreadPool::resolveThreadCount(jobs)) {
+        //
+    }
+
+    bool BuildScheduler::run(const BuildTask &task) {
+        const std::vector<DependencyNode> &nodes = this->graph.getNodes();
+
+        if (nodes.empty()) {
+            return true;
+        }
+        else if (!this->graph.findTopologicalOrder().has_value()) {
+            return false;
+        }
+
+        std::mutex mutex;
+        std::vector<size_t> remainingDependencies = std::vector<size_t>(nodes.size());
+        std::vector<bool> failedDependencies = std::vector<bool>(nodes.size(), false);
+        bool success = true;
+
+        // There is no point in spawning more workers than there are nodes.
+        uint32_t workerCount = std::min<size_t>(this->jobs, nodes.size());
+
+        /**
+         * Tasks share the jobs among them, so that their own parallelism
+         * (such as sharded passes) does not multiply the amount of threads.
+         */
+        ThreadPool threadPool = ThreadPool(workerCount, std::max<uint32_t>(1, this->jobs / workerCount));
+
+        std::function<void(size_t)> schedule;
+
+        /**
+         * Record the completion of a node, and schedule or skip its
+         * dependents which became ready as a result. Must be invoked
+         * while holding the mutex.
+         */
+        auto complete = [&](size_t index, bool succeeded) {
+            std::vector<std::pair<size_t, bool>> completed = {{index, succeeded}};
+
+            while (!completed.empty()) {
+                auto [current, currentSucceeded] = completed.back();
+
+                completed.pop_back();
+
+                if (!currentSucceeded) {
+                    success = false;
+                }
+
+                for (const auto dependent : nodes[current].dependents) {
+                    if (!currentSucceeded) {
+                        failedDependencies[dependent] = true;
+                    }
+
+                    if (--remainingDependencies[dependent] != 0) {
+                        continue;
+                    }
+                    // Skipped nodes complete immediately as failed.
+                    else if (failedDependencies[dependent]) {
+                        completed.emplace_back(dependent, false);
+                    }
+                    else {
+                        schedule(dependent);
+                    }
+                }
+            }
+        };
+
+        schedule = [&](size_t index) {
+            threadPool.submit([&, index] {
+                bool succeeded = task(index);
+                std::lock_guard<std::mutex> lock(mutex);
+
+                complete(index, succeeded);
+            });
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for (size_t index = 0; index < nodes.size(); index++) {
+                remainingDependencies[index] = nodes[index].dependencies.size();
+            }
+
+            for (size_t index = 0; index < nodes.size(); index++) {
+                if (remainingDependencies[index] == 0) {
+                    schedule(index);
+                }
+            }
+        }
+
+        threadPool.wait();
+
+        return success;
+    }
+}
@@ -0,0 +1,480 @@
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <ilc/misc/file_system.h>
+#include <ilc/misc/log.h>
+#include <ilc/misc/statistics.h>
+#include <ilc/processing/build_scheduler.h>
+#include <ilc/processing/build_session.h>
+#include <ilc/processing/dependency_graph.h>
+#include <ilc/processing/depfile.h>
+#include <ilc/processing/input_classifier.h>
+#include <ilc/processing/module_interface.h>
+#include <ilc/processing/snapshot.h>
+
+namespace ilc {
+    /**
+     * Output of the compilation running on the current thread. Compilations
+     * run concurrently, so their output is buffered and only flushed once
+     * each completes, to avoid interleaving it.
+     */
+    static thread_local std::string compilationOutput = "";
+
+    bool BuildSession::writeObjectFile(const std::filesystem::path &objectFilePath, const llvm::MemoryBuffer &object) {
+        std::ofstream objectStream = std::ofstream(objectFilePath, std::ios::binary | std::ios::trunc);
+
+        log::verbose("Generating '" + objectFilePath.string() + "'");
+        objectStream.write(object.getBufferStart(), object.getBufferSize());
+
+        if (!objectStream.good()) {
+            log::error("Could not write '" + objectFilePath.string() + "'");
+
+            return false;
+        }
+
+        return true;
+    }
+
+    void BuildSession::flushOutput() {
+        std::lock_guard<std::mutex> lock(this->outputMutex);
+
+        if (this->diagnosticSink != nullptr) {
+            this->diagnosticSink(compilationOutput);
+        }
+        else {
+            std::cout << compilationOutput;
+            std::cout.flush();
+        }
+
+        compilationOutput.clear();
+    }
+
+    std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> BuildSession::runLinkTimeOptimization(
+        CompilationSession &session,
+        const std::filesystem::path &outputDirectoryPath,
+        std::vector<std::unique_ptr<llvm::MemoryBuffer>> bitcodeBuffers
+    ) {
+        // The ThinLTO cache is kept inside the output directory by default.
+        std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> objects = session.runLinkTimeOptimization(
+            std::move(bitcodeBuffers),
+            std::filesystem::path(outputDirectoryPath).append(".ilc-cache").append("thinlto")
+        );
+
+        // Resulting objects are intermediate files when linking.
+        if (!objects.has_value() || !this->options.emit.contains(cli::EmitKind::Object)) {
+            return objects;
+        }
+
+        for (size_t i = 0; i < objects->size(); i++) {
+            std::filesystem::path objectFilePath = std::filesystem::path(outputDirectoryPath)
+                .append(objects->size() == 1 ? "lto.o" : "lto." + std::to_string(i) + ".o");
+
+            if (!BuildSession::writeObjectFile(objectFilePath, *(*objects)[i])) {
+                return std::nullopt;
+            }
+        }
+
+        return objects;
+    }
+
+    BuildSession::BuildSession(cli::Options options, DiagnosticSink diagnosticSink) :
+        options(std::move(options)),
+        diagnosticSink(std::move(diagnosticSink)) {
+        //
+    }
+
+    const cli::Options &BuildSession::getOptions() const noexcept {
+        return this->options;
+    }
+
+    bool BuildSession::run() {
+        log::verbose("Processing " + std::to_string(this->options.inputFilePaths.size()) + " input file(s)");
+
+        DependencyGraph dependencyGraph = DependencyGraph();
+        std::string outputFileExtension = ".o";
+        bool isExecutable = this->options.emit.contains(cli::EmitKind::Executable);
+        bool isSharedObject = this->options.emit.contains(cli::EmitKind::SharedObject);
+        bool isArchive = this->options.emit.contains(cli::EmitKind::Archive);
+        std::filesystem::path outputDirectoryPath = std::filesystem::path(this->options.out);
+        std::optional<std::filesystem::path> artifactFilePath = std::nullopt;
+
+        // Phases before code generation only report diagnostics, and write nothing.
+        bool isChecking = this->options.phaseLevel != cli::PhaseLevel::CodeGeneration;
+
+        // Link-time optimization requires bitcode outputs.
+        if (this->options.lto != cli::LtoKind::None) {
+            outputFileExtension = ".bc";
+        }
+
+        if ((int)isExecutable + (int)isSharedObject + (int)isArchive > 1) {
+            log::error("Cannot emit more than one of an executable, a shared object and an archive at once");
+
+            return false;
+        }
+        // Archives only hold object code, so LLVM IR would silently be left out of them.
+        else if (isArchive && this->options.emit.contains(cli::EmitKind::LlvmIr)) {
+            log::error("Cannot emit LLVM IR (--llvm-ir) when emitting an archive");
+
+            return false;
+        }
+        /**
+         * When linking or archiving, the output option names the resulting
+         * artifact, unless it refers to an existing directory.
+         */
+        else if (isExecutable || isSharedObject || isArchive) {
+            if (std::filesystem::is_directory(outputDirectoryPath)) {
+                artifactFilePath = std::filesystem::path(outputDirectoryPath)
+                    .append(isExecutable ? "a.out" : (isSharedObject ? "a.so" : "a.a"));
+            }
+            else {
+                artifactFilePath = outputDirectoryPath;
+                outputDirectoryPath = artifactFilePath->parent_path();
+
+                if (outputDirectoryPath.empty()) {
+                    outputDirectoryPath = ".";
+                }
+            }
+        }
+
+        // Create the output directory if it doesn't already exist.
+        if (!isChecking && !std::filesystem::exists(outputDirectoryPath)) {
+            log::verbose("Creating output directory '" + outputDirectoryPath.string() + "'");
+
+            // Ensure the directory was created, otherwise fail the build.
+            if (!std::filesystem::create_directories(outputDirectoryPath)) {
+                log::error("Output directory could not be created");
+
+                return false;
+            }
+        }
+
+        // Pre-scan all input files to determine the dependencies between them.
+        for (const auto &inputFilePath : this->options.inputFilePaths) {
+            std::optional<std::string> input = FileSystem::readFileContents(inputFilePath);
+
+            if (!input.has_value()) {
+                log::error("Could not read input file '" + inputFilePath + "'");
+
+                return false;
+            }
+
+            dependencyGraph.addInput(inputFilePath, *input);
+        }
+
+        // Interfaces of modules compiled by previous invocations are written next to their objects.
+        std::vector<std::filesystem::path> interfaceSearchPaths = {outputDirectoryPath};
+
+        interfaceSearchPaths.insert(
+            interfaceSearchPaths.end(),
+            this->options.modulePaths.begin(),
+            this->options.modulePaths.end()
+        );
+
+        dependencyGraph.link(interfaceSearchPaths);
+
+        if (!dependencyGraph.findTopologicalOrder().has_value()) {
+            log::error("Input files contain a cyclic module dependency");
+
+            return false;
+        }
+
+        // Every input is compiled through the same session, sharing its configuration.
+        CompilationSession session = CompilationSession(this->options, [](const std::string &text) {
+            compilationOutput += text;
+        });
+
+        log::verbose("Using target triple: " + session.getTargetTriple().getTriple());
+
+        BuildScheduler buildScheduler = BuildScheduler(dependencyGraph, this->options.jobs);
+        bool writesObjects = !isChecking && this->options.emit.contains(cli::EmitKind::Object);
+
+        bool writesFiles = writesObjects || (!isChecking && (this->options.emit.contains(cli::EmitKind::Assembly)
+            || this->options.emit.contains(cli::EmitKind::LlvmIr)
+            || this->options.emit.contains(cli::EmitKind::LlvmBitcode)));
+
+        // Each task only ever writes to its own slot.
+        std::vector<std::unique_ptr<llvm::MemoryBuffer>> outputBuffers =
+            std::vector<std::unique_ptr<llvm::MemoryBuffer>>(dependencyGraph.getNodes().size());
+
+        // Archive member names, matching the output buffers.
+        std::vector<std::string> memberNames = std::vector<std::string>(dependencyGraph.getNodes().size());
+
+        std::vector<PreludeFile> preludeFiles = {};
+        std::string prelude;
+
+        // Files which every output depends upon through the prelude.
+        std::vector<std::string> preludePrerequisites = {};
+
+        // Prelude files given explicitly take precedence over the snapshot's.
+        if (!this->options.preludeFilePaths.empty()) {
+            std::optional<std::vector<PreludeFile>> readPreludeFiles =
+                Snapshot::readPrelude(this->options.preludeFilePaths);
+
+            if (!readPreludeFiles.has_value()) {
+                log::error("Could not read prelude files");
+
+                return false;
+            }
+
+            preludeFiles = std::move(*readPreludeFiles);
+            prelude = Snapshot::extractPrelude(preludeFiles);
+            preludePrerequisites = this->options.preludeFilePaths;
+        }
+        else if (Snapshot::getActive().has_value()) {
+            preludeFiles = Snapshot::getActive()->preludeFiles;
+            prelude = Snapshot::getActive()->prelude;
+
+            // The prelude is read from the snapshot, which must be created again for prelude edits to apply.
+            if (!preludeFiles.empty()) {
+                preludePrerequisites.push_back(*this->options.snapshotPath);
+            }
+        }
+
+        // Only available once the corresponding input was compiled.
+        std::vector<std::string> interfaces = std::vector<std::string>(dependencyGraph.getNodes().size());
+
+        std::vector<std::filesystem::path> outputFilePaths = {};
+
+        // Written next to each output whenever objects are, for dependents to depend upon.
+        std::vector<std::string> interfaceFilePaths = {};
+
+        for (const auto &node : dependencyGraph.getNodes()) {
+            outputFilePaths.push_back(
+                std::filesystem::path(outputDirectoryPath)
+                    .append(node.inputFilePath)
+                    .concat(outputFileExtension)
+            );
+
+            interfaceFilePaths.push_back(ModuleInterface::makePath(outputFilePaths.back()).string());
+        }
+
+        auto buildTask = [&](size_t index) -> bool {
+            const DependencyNode &node = dependencyGraph.getNode(index);
+            InputKind inputKind = InputClassifier::classify(node.inputFilePath, node.input);
+            std::stringstream inputStringStream = std::stringstream();
+
+            /**
+             * Interfaces of the modules which the input depends upon are
+             * prepended to it, dependencies first. These only declare
+             * what the input may refer to, so they are cheap to process
+             * and their definitions are left to their own objects. Those
+             * of modules which are not among the inputs come from their
+             * interface files, and only ever depend upon one another.
+             */
+            inputStringStream << prelude;
+
+            for (const auto interfaceDependency : dependencyGraph.findInterfaceDependencies(index)) {
+                inputStringStream << dependencyGraph.getInterfaceNodes()[interfaceDependency].interface;
+            }
+
+            for (const auto dependency : dependencyGraph.findTransitiveDependencies(index)) {
+                inputStringStream << interfaces[dependency];
+            }
+
+            inputStringStream << node.input;
+
+            const std::filesystem::path &outputFilePath = outputFilePaths[index];
+
+            if (writesFiles) {
+                std::error_code errorCode = std::error_code();
+
+                // Input file paths may contain directories, which must be mirrored.
+                std::filesystem::create_directories(outputFilePath.parent_path(), errorCode);
+                log::verbose("Generating '" + outputFilePath.string() + "'");
+            }
+
+            std::optional<RemarksOpts> remarksOpts = std::nullopt;
+
+            if (this->options.remarksOutput.has_value()) {
+                remarksOpts.emplace(RemarksOpts{
+                    dependencyGraph.getNodes().size() == 1
+                        ? std::filesystem::path(*this->options.remarksOutput)
+                        : Remarks::makePath(*this->options.remarksOutput, node.inputFilePath),
+
+                    this->options.remarksFilter
+                });
+            }
+
+            // LLVM inputs are handed over as-is, without the prelude or any interface.
+            std::optional<std::unique_ptr<llvm::MemoryBuffer>> output = session.compile(CompilationInput{
+                node.inputFilePath,
+                InputClassifier::isBackendInput(inputKind) ? node.input : inputStringStream.str(),
+                outputFilePath,
+                remarksOpts
+            });
+
+            if (!output.has_value()) {
+                return false;
+            }
+
+            outputBuffers[index] = std::move(*output);
+            memberNames[index] = std::filesystem::path(node.inputFilePath).filename().concat(outputFileExtension).string();
+
+            // LLVM inputs declare nothing which Ion sources could refer to.
+            if (!InputClassifier::isBackendInput(inputKind)) {
+                interfaces[index] = ModuleInterface::extract(node.input);
+            }
+
+            if (writesObjects) {
+                if (!ModuleInterface::write(interfaceFilePaths[index], interfaces[index])) {
+                    log::error("Could not write module interface '" + interfaceFilePaths[index] + "'");
+
+                    return false;
+                }
+            }
+
+            if (writesObjects && !this->options.noDepfile) {
+                std::filesystem::path depfilePath = Depfile::makePath(outputFilePath);
+                std::vector<std::string> prerequisites = dependencyGraph.findPrerequisites(index, interfaceFilePaths);
+
+                // LLVM inputs are compiled without the prelude.
+                if (!InputClassifier::isBackendInput(inputKind)) {
+                    prerequisites.insert(prerequisites.end(), preludePrerequisites.begin(), preludePrerequisites.end());
+                }
+
+                bool depfileWritten = Depfile::write(depfilePath, outputFilePath.string(), prerequisites);
+
+                if (!depfileWritten) {
+                    log::error("Could not write depfile '" + depfilePath.string() + "'");
+
+                    return false;
+                }
+            }
+
+            return true;
+        };
+
+        bool success = buildScheduler.run([&](size_t index) -> bool {
+            bool taskSuccess = buildTask(index);
+
+            this->flushOutput();
+
+            return taskSuccess;
+        });
+
+        /**
+         * Inputs only see the prelude's interface, so its definitions
+         * are compiled once into objects of their own, which are linked
+         * or archived along with the inputs' objects. Each prelude file
+         * sees the interfaces of those preceding it.
+         */
+        std::string precedingPrelude;
+
+        for (size_t i = 0; success && !isChecking && i < preludeFiles.size(); i++) {
+            const PreludeFile &preludeFile = preludeFiles[i];
+            std::string fileName = std::filesystem::path(preludeFile.filePath).filename().string();
+
+            std::filesystem::path outputFilePath = std::filesystem::path(outputDirectoryPath)
+                .append("prelude")
+                .append(fileName)
+                .concat(outputFileExtension);
+
+            if (writesFiles) {
+                std::error_code errorCode = std::error_code();
+
+                std::filesystem::create_directories(outputFilePath.parent_path(), errorCode);
+                log::verbose("Generating '" + outputFilePath.string() + "'");
+            }
+
+            std::optional<std::unique_ptr<llvm::MemoryBuffer>> output = session.compile(CompilationInput{
+                preludeFile.filePath,
+                precedingPrelude + preludeFile.source,
+                outputFilePath
+            });
+
+            this->flushOutput();
+            precedingPrelude += ModuleInterface::extract(preludeFile.source);
+
+            if (!output.has_value()) {
+                success = false;
+
+                break;
+            }
+
+            outputBuffers.push_back(std::move(*output));
+            memberNames.push_back(fileName + outputFileExtension);
+
+            if (writesObjects && !this->options.noDepfile) {
+                std::filesystem::path depfilePath = Depfile::makePath(outputFilePath);
+
+                if (!Depfile::write(depfilePath, outputFilePath.string(), preludePrerequisites)) {
+                    log::error("Could not write depfile '" + depfilePath.string() + "'");
+                    success = false;
+                }
+            }
+        }
+
+        if (isChecking) {
+            if (!success) {
+                log::error("Check completed unsuccessfully");
+
+                return false;
+            }
+
+            return true;
+        }
+
+        // Nothing is left to optimize at link time when only emitting per-input artifacts.
+        bool needsObjects = this->options.emit.contains(cli::EmitKind::Object) || artifactFilePath.has_value();
+
+        if (success && this->options.lto != cli::LtoKind::None && needsObjects) {
+            std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> objects =
+                this->runLinkTimeOptimization(session, outputDirectoryPath, std::move(outputBuffers));
+
+            success = objects.has_value();
+
+            if (success) {
+                outputBuffers = std::move(*objects);
+                memberNames.clear();
+
+                // The link-time step produces objects of its own, one per task.
+                for (size_t i = 0; i < outputBuffers.size(); i++) {
+                    memberNames.push_back("lto." + std::to_string(i) + ".o");
+                }
+            }
+        }
+
+        if (success && artifactFilePath.has_value()) {
+            success = isArchive
+                ? session.archive(outputBuffers, memberNames, *artifactFilePath)
+                : session.link(outputBuffers, *artifactFilePath);
+
+            if (success && Statistics::isEnabled()) {
+                std::error_code errorCode = std::error_code();
+                uintmax_t artifactSize = std::filesystem::file_size(*artifactFilePath, errorCode);
+
+                if (!errorCode) {
+                    Statistics::add(isArchive ? "archiver" : "linker", "bytes-emitted", artifactSize);
+                }
+            }
+
+            // The artifact depends upon the sources of every input, whose objects it combines.
+            if (success && !this->options.noDepfile) {
+                std::vector<std::string> prerequisites = dependencyGraph.findArtifactPrerequisites();
+                std::set<std::string> seen = std::set<std::string>(prerequisites.begin(), prerequisites.end());
+
+                for (const auto &prerequisite : preludePrerequisites) {
+                    if (seen.insert(prerequisite).second) {
+                        prerequisites.push_back(prerequisite);
+                    }
+                }
+
+                std::filesystem::path depfilePath = Depfile::makePath(*artifactFilePath);
+
+                if (!Depfile::write(depfilePath, artifactFilePath->string(), prerequisites)) {
+                    log::error("Could not write depfile '" + depfilePath.string() + "'");
+                    success = false;
+                }
+            }
+        }
+
+        if (!success) {
+            log::error("Generation completed unsuccessfully");
+
+            return false;
+        }
+
+        return true;
+    }
+}
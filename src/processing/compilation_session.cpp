@@ -0,0 +1,235 @@
+#include <llvm/Support/Host.h>
+#include <llvm/Support/SHA1.h>
+#include <ilc/misc/log.h>
+#include <ilc/misc/size_report.h>
+#include <ilc/processing/archiver.h>
+#include <ilc/processing/ast_cache.h>
+#include <ilc/processing/compilation_session.h>
+#include <ilc/processing/input_classifier.h>
+#include <ilc/processing/linker.h>
+#include <ilc/processing/lto_linker.h>
+#include <ilc/processing/snapshot.h>
+#include <ilc/processing/target_setup.h>
+
+namespace ilc {
+    std::string CompilationSession::findObjectCacheKey(const CompilationInput &input) const {
+        llvm::SHA1 hasher = llvm::SHA1();
+
+        hasher.update(AstCache::findContentHash(
+            input.contents,
+            this->targetTriple,
+            this->options.passes,
+            TargetSetup::findOptimizationLevel(this->options) > 0
+        ));
+
+        hasher.update(";");
+        hasher.update(TargetSetup::findConfigurationKey(this->targetTriple, this->options));
+
+        // The name determines whether the input is an Ion source or an LLVM input.
+        hasher.update(";" + std::filesystem::path(input.name).extension().string());
+        hasher.update(";lto" + std::to_string((int)this->options.lto));
+
+        return hasher.final().str();
+    }
+
+    std::optional<std::string> CompilationSession::findCachedObject(const std::string &key) {
+        auto entry = this->objectCacheEntries.find(key);
+
+        if (entry == this->objectCacheEntries.end()) {
+            return std::nullopt;
+        }
+
+        this->objectCache.splice(this->objectCache.begin(), this->objectCache, entry->second);
+
+        return entry->second->second;
+    }
+
+    void CompilationSession::cacheObject(const std::string &key, std::string object) {
+        // Outputs larger than the whole cache would only evict everything else.
+        if (object.size() > this->objectCacheCapacity || this->objectCacheEntries.count(key) != 0) {
+            return;
+        }
+
+        this->objectCacheSize += object.size();
+        this->objectCache.emplace_front(key, std::move(object));
+        this->objectCacheEntries[key] = this->objectCache.begin();
+
+        while (this->objectCacheSize > this->objectCacheCapacity) {
+            auto &[leastRecentKey, leastRecentObject] = this->objectCache.back();
+
+            this->objectCacheSize -= leastRecentObject.size();
+            this->objectCacheEntries.erase(leastRecentKey);
+            this->objectCache.pop_back();
+        }
+    }
+
+    llvm::Triple CompilationSession::findTargetTriple(const cli::Options &options) {
+        return llvm::Triple(options.target.value_or(
+            Snapshot::getActive().has_value()
+                ? Snapshot::getActive()->hostTriple
+                : llvm::sys::getDefaultTargetTriple()
+        ));
+    }
+
+    CompilationSession::CompilationSession(
+        cli::Options options,
+        DiagnosticSink diagnosticSink,
+        size_t objectCacheCapacity
+    ) :
+        options(std::move(options)),
+        diagnosticSink(std::move(diagnosticSink)),
+        targetTriple(CompilationSession::findTargetTriple(this->options)),
+        objectCacheCapacity(objectCacheCapacity) {
+        //
+    }
+
+    const cli::Options &CompilationSession::getOptions() const noexcept {
+        return this->options;
+    }
+
+    const llvm::Triple &CompilationSession::getTargetTriple() const noexcept {
+        return this->targetTriple;
+    }
+
+    std::optional<std::unique_ptr<llvm::MemoryBuffer>> CompilationSession::compile(const CompilationInput &input) {
+        InputKind inputKind = InputClassifier::classify(input.name, input.contents);
+        bool isInMemory = !input.outputFilePath.has_value();
+        std::optional<std::string> objectCacheKey = std::nullopt;
+
+        // Remarks and size reports are side effects of compiling, so their inputs are always compiled.
+        bool hasSideEffects = input.remarksOpts.has_value() || SizeReport::isEnabled();
+
+        if (isInMemory
+            && this->objectCacheCapacity > 0
+            && this->options.phaseLevel == cli::PhaseLevel::CodeGeneration
+            && !hasSideEffects) {
+            objectCacheKey = this->findObjectCacheKey(input);
+
+            std::lock_guard<std::mutex> lock(this->objectCacheMutex);
+            std::optional<std::string> cachedObject = this->findCachedObject(*objectCacheKey);
+
+            if (cachedObject.has_value()) {
+                return llvm::MemoryBuffer::getMemBufferCopy(*cachedObject, input.name);
+            }
+        }
+
+        cli::Options driverOptions = this->options;
+
+        /**
+         * In-memory compilations write nothing to disk, besides caches
+         * explicitly given a directory.
+         */
+        if (isInMemory) {
+            driverOptions.emit.erase(cli::EmitKind::Object);
+            driverOptions.emit.erase(cli::EmitKind::Assembly);
+            driverOptions.emit.erase(cli::EmitKind::LlvmIr);
+            driverOptions.emit.erase(cli::EmitKind::LlvmBitcode);
+            driverOptions.noAstCache = true;
+            driverOptions.incremental = driverOptions.incremental && driverOptions.incrementalCacheDirectory.has_value();
+        }
+
+        Driver driver = Driver(driverOptions, this->diagnosticSink);
+
+        std::filesystem::path outputFilePath =
+            input.outputFilePath.value_or(std::filesystem::path(input.name).concat(".o"));
+
+        bool success = InputClassifier::isBackendInput(inputKind)
+            ? driver.runBackend(this->targetTriple, outputFilePath, input.contents, inputKind, input.remarksOpts)
+            : driver.run(this->targetTriple, outputFilePath, input.contents, input.remarksOpts);
+
+        if (!success) {
+            return std::nullopt;
+        }
+
+        std::unique_ptr<llvm::MemoryBuffer> output = driver.takeOutputBuffer();
+
+        if (SizeReport::isEnabled()) {
+            SizeReport::add(input.name, driver.takeFunctionSizes());
+        }
+
+        if (objectCacheKey.has_value() && output != nullptr) {
+            std::lock_guard<std::mutex> lock(this->objectCacheMutex);
+
+            this->cacheObject(*objectCacheKey, output->getBuffer().str());
+        }
+
+        return output;
+    }
+
+    std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> CompilationSession::runLinkTimeOptimization(
+        std::vector<std::unique_ptr<llvm::MemoryBuffer>> bitcodeBuffers,
+        const std::optional<std::filesystem::path> &defaultCacheDirectory
+    ) {
+        bool isThin = this->options.lto == cli::LtoKind::Thin;
+        std::optional<std::filesystem::path> cacheDirectory = std::nullopt;
+
+        if (isThin) {
+            cacheDirectory = this->options.ltoCacheDirectory.has_value()
+                ? std::make_optional(std::filesystem::path(*this->options.ltoCacheDirectory))
+                : defaultCacheDirectory;
+        }
+
+        LtoLinker ltoLinker = LtoLinker(LtoLinkerOpts{
+            this->options.lto,
+            this->targetTriple,
+            TargetSetup::findCpuName(this->targetTriple, this->options),
+            TargetSetup::findCpuFeatures(this->targetTriple, this->options),
+            TargetSetup::findOptimizationLevel(this->options),
+            TargetSetup::findCodeGenOptimizationLevel(this->options),
+            this->options.jobs,
+            cacheDirectory,
+            this->options.ltoInternalize,
+
+            this->options.remarksOutput.has_value()
+                ? std::make_optional(Remarks::makePath(*this->options.remarksOutput, "lto"))
+                : std::nullopt,
+
+            this->options.remarksFilter
+        });
+
+        TargetSetup::initializeTarget(this->targetTriple);
+        log::verbose(std::string("Running ") + (isThin ? "ThinLTO" : "full LTO") + " link-time step");
+
+        for (auto &bitcodeBuffer : bitcodeBuffers) {
+            ltoLinker.addInput(std::move(bitcodeBuffer));
+        }
+
+        return ltoLinker.link();
+    }
+
+    bool CompilationSession::link(
+        const std::vector<std::unique_ptr<llvm::MemoryBuffer>> &objects,
+        const std::filesystem::path &artifactFilePath
+    ) {
+        log::verbose("Linking '" + artifactFilePath.string() + "'");
+
+        Linker linker = Linker(LinkerOpts{
+            this->options.emit.contains(cli::EmitKind::SharedObject) ? LinkKind::SharedObject : LinkKind::Executable,
+            artifactFilePath,
+            this->targetTriple,
+            this->options.gcSections,
+            this->options.icf,
+            !this->options.noDefaultLibraries,
+            this->options.linkerArguments,
+            this->options.profileGenerate,
+            this->options.profileRuntime
+        });
+
+        return linker.link(objects);
+    }
+
+    bool CompilationSession::archive(
+        const std::vector<std::unique_ptr<llvm::MemoryBuffer>> &objects,
+        const std::vector<std::string> &memberNames,
+        const std::filesystem::path &artifactFilePath
+    ) {
+        log::verbose("Archiving '" + artifactFilePath.string() + "'");
+
+        Archiver archiver = Archiver(ArchiverOpts{
+            artifactFilePath,
+            this->targetTriple
+        });
+
+        return archiver.archive(objects, memberNames);
+    }
+}
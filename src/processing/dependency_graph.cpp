@@ -0,0 +1,366 @@
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+#include <ilc/misc/file_system.h>
+#include <ilc/processing/dependency_graph.h>
+#include <ilc/processing/module_interface.h>
+
+namespace ilc {
+    std::optional<std::filesystem::path> DependencyGraph::resolveIncludePath(
+        const std::filesystem::path &includingFilePath,
+        const std::string &includePath
+    ) {
+        // Includes are first resolved relative to the including file.
+        std::filesystem::path candidate = includingFilePath.parent_path() / includePath;
+
+        if (std::filesystem::exists(candidate)) {
+            return candidate.lexically_normal();
+        }
+
+        // Otherwise, fallback to the working directory.
+        candidate = std::filesystem::path(includePath);
+
+        if (std::filesystem::exists(candidate)) {
+            return candidate.lexically_normal();
+        }
+
+        return std::nullopt;
+    }
+
+    void DependencyGraph::collectIncludes(
+        const std::filesystem::path &filePath,
+        const SourceDependencies &sourceDependencies,
+        std::set<std::string> &includedFilePaths
+    ) {
+        for (const auto &includePath : sourceDependencies.includes) {
+            std::optional<std::filesystem::path> resolvedPath =
+                DependencyGraph::resolveIncludePath(filePath, includePath);
+
+            /**
+             * Unresolvable includes are left for the compiler to report,
+             * and must not be listed in a depfile, since build systems
+             * would then fail looking for a rule to create them.
+             */
+            if (!resolvedPath.has_value()) {
+                continue;
+            }
+
+            // Skip files already visited to handle include cycles.
+            if (!includedFilePaths.insert(resolvedPath->string()).second) {
+                continue;
+            }
+
+            std::optional<std::string> contents =
+                FileSystem::readFileContents(resolvedPath->string());
+
+            if (contents.has_value()) {
+                this->collectIncludes(
+                    *resolvedPath,
+                    DependencyScanner::scan(*contents),
+                    includedFilePaths
+                );
+            }
+        }
+    }
+
+    std::optional<size_t> DependencyGraph::loadInterface(
+        const std::string &moduleName,
+        const std::map<std::string, std::filesystem::path> &interfaceFilePaths
+    ) {
+        if (auto owner = this->interfaceOwners.find(moduleName); owner != this->interfaceOwners.end()) {
+            return owner->second;
+        }
+
+        auto interfaceFilePath = interfaceFilePaths.find(moduleName);
+
+        if (interfaceFilePath == interfaceFilePaths.end()) {
+            return std::nullopt;
+        }
+
+        std::optional<std::string> interface = ModuleInterface::read(interfaceFilePath->second);
+
+        if (!interface.has_value()) {
+            return std::nullopt;
+        }
+
+        SourceDependencies sourceDependencies = DependencyScanner::scan(*interface);
+        size_t index = this->interfaceNodes.size();
+
+        this->interfaceNodes.push_back(InterfaceNode{
+            interfaceFilePath->second.string(),
+            std::move(*interface)
+        });
+
+        // Registered before following references, so that cyclic interfaces terminate.
+        for (const auto &declaredModuleName : sourceDependencies.declaredModules) {
+            this->interfaceOwners.insert({declaredModuleName, index});
+        }
+
+        for (const auto &referencedModuleName : sourceDependencies.referencedModules) {
+            // Modules declared by inputs reach dependents through the inputs' own interfaces.
+            if (this->moduleOwners.count(referencedModuleName) != 0) {
+                continue;
+            }
+
+            std::optional<size_t> dependency = this->loadInterface(referencedModuleName, interfaceFilePaths);
+
+            if (dependency.has_value() && *dependency != index) {
+                this->interfaceNodes[index].dependencies.insert(*dependency);
+            }
+        }
+
+        return index;
+    }
+
+    size_t DependencyGraph::addInput(std::string inputFilePath, std::string input) {
+        SourceDependencies sourceDependencies = DependencyScanner::scan(input);
+        size_t index = this->nodes.size();
+
+        for (const auto &moduleName : sourceDependencies.declaredModules) {
+            // Only register the first declaring input as the module's owner.
+            this->moduleOwners.insert({moduleName, index});
+        }
+
+        this->nodes.push_back(DependencyNode{
+            std::move(inputFilePath),
+            std::move(input),
+            std::move(sourceDependencies)
+        });
+
+        return index;
+    }
+
+    void DependencyGraph::link(const std::vector<std::filesystem::path> &interfaceSearchPaths) {
+        // Only searched for once a module which no input declares is referenced.
+        std::optional<std::map<std::string, std::filesystem::path>> interfaceFilePaths = std::nullopt;
+
+        for (size_t index = 0; index < this->nodes.size(); index++) {
+            DependencyNode &node = this->nodes[index];
+
+            this->collectIncludes(
+                node.inputFilePath,
+                node.sourceDependencies,
+                node.includedFilePaths
+            );
+
+            for (const auto &moduleName : node.sourceDependencies.referencedModules) {
+                auto owner = this->moduleOwners.find(moduleName);
+
+                if (owner == this->moduleOwners.end()) {
+                    if (!interfaceFilePaths.has_value()) {
+                        interfaceFilePaths = ModuleInterface::findInterfaceFiles(interfaceSearchPaths);
+                    }
+
+                    // References to unknown modules are left for name resolution to report.
+                    std::optional<size_t> interfaceIndex = this->loadInterface(moduleName, *interfaceFilePaths);
+
+                    if (interfaceIndex.has_value()) {
+                        node.interfaceDependencies.insert(*interfaceIndex);
+                    }
+
+                    continue;
+                }
+                // References to self-declared modules create no edges.
+                else if (owner->second == index) {
+                    continue;
+                }
+
+                node.dependencies.insert(owner->second);
+                this->nodes[owner->second].dependents.insert(index);
+            }
+        }
+    }
+
+    const std::vector<DependencyNode> &DependencyGraph::getNodes() const noexcept {
+        return this->nodes;
+    }
+
+    const DependencyNode &DependencyGraph::getNode(size_t index) const {
+        if (index >= this->nodes.size()) {
+            throw std::out_of_range("Dependency graph node index is out of range");
+        }
+
+        return this->nodes[index];
+    }
+
+    const std::vector<InterfaceNode> &DependencyGraph::getInterfaceNodes() const noexcept {
+        return this->interfaceNodes;
+    }
+
+    std::optional<std::vector<size_t>> DependencyGraph::findTopologicalOrder() const {
+        std::vector<size_t> result = {};
+        std::vector<size_t> remainingDependencies = std::vector<size_t>(this->nodes.size());
+        std::queue<size_t> ready = {};
+
+        for (size_t index = 0; index < this->nodes.size(); index++) {
+            remainingDependencies[index] = this->nodes[index].dependencies.size();
+
+            if (remainingDependencies[index] == 0) {
+                ready.push(index);
+            }
+        }
+
+        // Kahn's algorithm.
+        while (!ready.empty()) {
+            size_t index = ready.front();
+
+            ready.pop();
+            result.push_back(index);
+
+            for (const auto dependent : this->nodes[index].dependents) {
+                if (--remainingDependencies[dependent] == 0) {
+                    ready.push(dependent);
+                }
+            }
+        }
+
+        // Nodes which were never ready are part of (or depend upon) a cycle.
+        if (result.size() != this->nodes.size()) {
+            return std::nullopt;
+        }
+
+        return result;
+    }
+
+    std::vector<size_t> DependencyGraph::findTransitiveDependencies(size_t index) const {
+        std::vector<size_t> result = {};
+        std::vector<bool> visited = std::vector<bool>(this->nodes.size(), false);
+
+        // Iterative post-order traversal: (node, whether its dependencies were expanded).
+        std::vector<std::pair<size_t, bool>> stack = {{index, false}};
+
+        while (!stack.empty()) {
+            auto [current, expanded] = stack.back();
+
+            stack.pop_back();
+
+            if (expanded) {
+                if (current != index) {
+                    result.push_back(current);
+                }
+
+                continue;
+            }
+            /**
+             * A node may be pushed more than once before being expanded;
+             * only its first expansion counts.
+             */
+            else if (visited[current]) {
+                continue;
+            }
+
+            visited[current] = true;
+            stack.emplace_back(current, true);
+
+            for (const auto dependency : this->getNode(current).dependencies) {
+                if (!visited[dependency]) {
+                    stack.emplace_back(dependency, false);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<size_t> DependencyGraph::findInterfaceDependencies(size_t index) const {
+        std::vector<size_t> result = {};
+        std::vector<bool> visited = std::vector<bool>(this->interfaceNodes.size(), false);
+        std::vector<size_t> inputs = this->findTransitiveDependencies(index);
+
+        inputs.push_back(index);
+
+        // Iterative post-order traversal, as in findTransitiveDependencies().
+        std::vector<std::pair<size_t, bool>> stack = {};
+
+        for (const auto input : inputs) {
+            for (const auto interfaceDependency : this->getNode(input).interfaceDependencies) {
+                stack.emplace_back(interfaceDependency, false);
+            }
+        }
+
+        // The stack is consumed from its back, so reverse it to visit interfaces in order of reference.
+        std::reverse(stack.begin(), stack.end());
+
+        while (!stack.empty()) {
+            auto [current, expanded] = stack.back();
+
+            stack.pop_back();
+
+            if (expanded) {
+                result.push_back(current);
+
+                continue;
+            }
+            else if (visited[current]) {
+                continue;
+            }
+
+            visited[current] = true;
+            stack.emplace_back(current, true);
+
+            for (const auto dependency : this->interfaceNodes[current].dependencies) {
+                if (!visited[dependency]) {
+                    stack.emplace_back(dependency, false);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<std::string> DependencyGraph::findPrerequisites(
+        size_t index,
+        const std::vector<std::string> &interfaceFilePaths
+    ) const {
+        const DependencyNode &node = this->getNode(index);
+        std::vector<std::string> result = {node.inputFilePath};
+        std::set<std::string> seen = {node.inputFilePath};
+
+        auto append = [&](const std::string &filePath) {
+            if (seen.insert(filePath).second) {
+                result.push_back(filePath);
+            }
+        };
+
+        for (const auto &includedFilePath : node.includedFilePaths) {
+            append(includedFilePath);
+        }
+
+        for (const auto dependency : this->findTransitiveDependencies(index)) {
+            append(interfaceFilePaths.at(dependency));
+        }
+
+        for (const auto interfaceDependency : this->findInterfaceDependencies(index)) {
+            append(this->interfaceNodes[interfaceDependency].interfaceFilePath);
+        }
+
+        return result;
+    }
+
+    std::vector<std::string> DependencyGraph::findArtifactPrerequisites() const {
+        std::vector<std::string> result = {};
+        std::set<std::string> seen = {};
+
+        auto append = [&](const std::string &filePath) {
+            if (seen.insert(filePath).second) {
+                result.push_back(filePath);
+            }
+        };
+
+        for (const auto &node : this->nodes) {
+            append(node.inputFilePath);
+
+            for (const auto &includedFilePath : node.includedFilePaths) {
+                append(includedFilePath);
+            }
+        }
+
+        for (size_t index = 0; index < this->nodes.size(); index++) {
+            for (const auto interfaceDependency : this->findInterfaceDependencies(index)) {
+                append(this->interfaceNodes[interfaceDependency].interfaceFilePath);
+            }
+        }
+
+        return result;
+    }
+}
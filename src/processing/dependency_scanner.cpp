@@ -0,0 +1,146 @@
+#include <cctype>
+#include <ilc/processing/dependency_scanner.h>
+
+namespace ilc {
+    namespace {
+        enum class ScanTokenKind {
+            None,
+
+            Identifier,
+
+            String,
+
+            Hash,
+
+            DoubleColon,
+
+            Other
+        };
+
+        struct ScanToken {
+            ScanTokenKind kind = ScanTokenKind::None;
+
+            std::string value = "";
+        };
+
+        bool isIdentifierStart(char character) {
+            return std::isalpha(static_cast<unsigned char>(character)) || character == '_';
+        }
+
+        bool isIdentifierPart(char character) {
+            return std::isalnum(static_cast<unsigned char>(character)) || character == '_';
+        }
+    }
+
+    SourceDependencies DependencyScanner::scan(const std::string &input) {
+        SourceDependencies result = SourceDependencies();
+        const size_t length = input.length();
+        size_t position = 0;
+
+        /**
+         * Only the last two tokens are ever required to recognize
+         * a pattern, so there is no need to buffer the whole stream.
+         */
+        ScanToken previous = ScanToken();
+        ScanToken beforePrevious = ScanToken();
+
+        while (position < length) {
+            const char character = input[position];
+            ScanToken token = ScanToken();
+
+            if (std::isspace(static_cast<unsigned char>(character))) {
+                position++;
+
+                continue;
+            }
+            // Line comment.
+            else if (input.compare(position, 2, "//") == 0) {
+                position = input.find('\n', position);
+
+                if (position == std::string::npos) {
+                    break;
+                }
+
+                continue;
+            }
+            // Block comment.
+            else if (input.compare(position, 2, "/*") == 0) {
+                position = input.find("*/", position + 2);
+
+                if (position == std::string::npos) {
+                    break;
+                }
+
+                position += 2;
+
+                continue;
+            }
+            else if (character == '"') {
+                size_t start = ++position;
+
+                while (position < length && input[position] != '"') {
+                    // Skip over escaped characters.
+                    if (input[position] == '\\') {
+                        position++;
+                    }
+
+                    position++;
+                }
+
+                token = ScanToken{ScanTokenKind::String, input.substr(start, position - start)};
+                position++;
+            }
+            else if (isIdentifierStart(character)) {
+                size_t start = position;
+
+                while (position < length && isIdentifierPart(input[position])) {
+                    position++;
+                }
+
+                token = ScanToken{ScanTokenKind::Identifier, input.substr(start, position - start)};
+            }
+            else if (character == '#') {
+                token = ScanToken{ScanTokenKind::Hash};
+                position++;
+            }
+            else if (input.compare(position, 2, "::") == 0) {
+                token = ScanToken{ScanTokenKind::DoubleColon};
+                position += 2;
+            }
+            else {
+                token = ScanToken{ScanTokenKind::Other};
+                position++;
+            }
+
+            // '#include "path"' or '#include path'.
+            if (beforePrevious.kind == ScanTokenKind::Hash
+                && previous.kind == ScanTokenKind::Identifier
+                && previous.value == "include"
+                && (token.kind == ScanTokenKind::String || token.kind == ScanTokenKind::Identifier)) {
+                result.includes.push_back(token.value);
+            }
+            // 'module name'.
+            else if (previous.kind == ScanTokenKind::Identifier
+                && previous.value == "module"
+                && token.kind == ScanTokenKind::Identifier) {
+                result.declaredModules.insert(token.value);
+            }
+            // 'import name'.
+            else if (previous.kind == ScanTokenKind::Identifier
+                && previous.value == "import"
+                && token.kind == ScanTokenKind::Identifier) {
+                result.referencedModules.insert(token.value);
+            }
+            // 'name::'.
+            else if (previous.kind == ScanTokenKind::Identifier
+                && token.kind == ScanTokenKind::DoubleColon) {
+                result.referencedModules.insert(previous.value);
+            }
+
+            beforePrevious = std::move(previous);
+            previous = std::move(token);
+        }
+
+        return result;
+    }
+}
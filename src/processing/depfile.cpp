@@ -0,0 +1,61 @@
+#include <fstream>
+#include <ilc/processing/depfile.h>
+
+namespace ilc {
+    std::string Depfile::escape(const std::string &path) {
+        std::string result;
+
+        result.reserve(path.length());
+
+        for (const char character : path) {
+            switch (character) {
+                case ' ':
+                case '#': {
+                    result += '\\';
+                    result += character;
+
+                    break;
+                }
+
+                case '$': {
+                    result += "$$";
+
+                    break;
+                }
+
+                default: {
+                    result += character;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    std::filesystem::path Depfile::makePath(const std::filesystem::path &outputFilePath) {
+        return std::filesystem::path(outputFilePath).concat(".d");
+    }
+
+    bool Depfile::write(
+        const std::filesystem::path &depfilePath,
+        const std::string &target,
+        const std::vector<std::string> &prerequisites
+    ) {
+        std::ofstream stream = std::ofstream(depfilePath, std::ios::trunc);
+
+        if (!stream.is_open()) {
+            return false;
+        }
+
+        stream << Depfile::escape(target) << ":";
+
+        // Place each prerequisite on its own line to keep the file diff-friendly.
+        for (const auto &prerequisite : prerequisites) {
+            stream << " \\\n  " << Depfile::escape(prerequisite);
+        }
+
+        stream << "\n";
+
+        return stream.good();
+    }
+}
@@ -1,44 +1,102 @@
+#include <map>
 #include <memory>
+#include <sstream>
 #include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/StringExtras.h>
 #include <llvm/ADT/Triple.h>
+#include <llvm/Analysis/ModuleSummaryAnalysis.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
+#include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/CodeGen/CommandFlags.inc>
 #include <llvm/CodeGen/LinkAllCodegenComponents.h>
 #include <llvm/CodeGen/MIRParser/MIRParser.h>
 #include <llvm/CodeGen/MachineFunctionPass.h>
 #include <llvm/CodeGen/MachineModuleInfo.h>
+#include <llvm/CodeGen/TargetOpcodes.h>
 #include <llvm/CodeGen/TargetPassConfig.h>
 #include <llvm/CodeGen/TargetSubtargetInfo.h>
 #include <llvm/IR/DiagnosticInfo.h>
 #include <llvm/IR/DiagnosticPrinter.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/RemarkStreamer.h>
+#include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/FormattedStream.h>
+#include <llvm/Support/SmallVectorMemoryBuffer.h>
 #include <llvm/Support/TargetRegistry.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/xxhash.h>
+#include <llvm/Transforms/IPO.h>
+#include <llvm/Transforms/IPO/AlwaysInliner.h>
+#include <llvm/Transforms/IPO/PassManagerBuilder.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 #include <ionshared/diagnostics/diagnostic.h>
-#include <ionshared/llvm/llvm_module.h>
-#include <ionir/passes/codegen/llvm_codegen_pass.h>
 #include <ionir/passes/type_system/type_check_pass.h>
 #include <ionir/passes/type_system/borrow_check_pass.h>
 #include <ionir/passes/semantic/entry_point_check_pass.h>
-#include <ionlang/passes/lowering/ionir_lowering_pass.h>
 #include <ionlang/passes/semantic/macro_expansion_pass.h>
 #include <ionlang/passes/semantic/name_resolution_pass.h>
 #include <ionlang/lexical/lexer.h>
 #include <ionlang/syntax/parser.h>
+#include <ilc/passes/ionir/counted_dead_code_elimination_pass.h>
+#include <ilc/passes/ionir/ionir_constant_folding_pass.h>
+#include <ilc/passes/ionir/ionir_dead_function_stripping_pass.h>
+#include <ilc/passes/ionir/ionir_unreachable_block_removal_pass.h>
+#include <ilc/passes/ionir/timed_llvm_codegen_pass.h>
 #include <ilc/passes/ionlang/ionlang_logger_pass.h>
+#include <ilc/passes/ionlang/timed_ionir_lowering_pass.h>
 #include <ilc/diagnostics/diagnostic_printer.h>
+#include <ilc/ast/ast_tracer.h>
+#include <ilc/misc/function_time_report.h>
 #include <ilc/misc/log.h>
+#include <ilc/misc/perf_counters.h>
+#include <ilc/misc/size_report.h>
+#include <ilc/misc/static_init.h>
+#include <ilc/misc/statistics.h>
+#include <ilc/processing/ast_cache.h>
+#include <ilc/processing/function_multiversioning.h>
+#include <ilc/processing/incremental_codegen.h>
+#include <ilc/processing/input_classifier.h>
+#include <ilc/processing/pass_scheduler.h>
+#include <ilc/processing/target_setup.h>
 #include <ilc/processing/driver.h>
 
 namespace ilc {
     std::vector<ionlang::Token> Driver::lex() {
-        ionlang::Lexer lexer = ionlang::Lexer(this->input);
-        std::vector<ionlang::Token> tokens = lexer.scan();
+        StaticInit::ensureInitialized();
 
-        std::cout
-            << ConsoleColor::coat(
+        std::vector<ionlang::Token> tokens = {};
+
+        {
+            PerfPhase perfPhase = PerfPhase("lex");
+            ionlang::Lexer lexer = ionlang::Lexer(this->input);
+
+            tokens = lexer.scan();
+        }
+
+        if (Statistics::isEnabled()) {
+            std::map<int, uint64_t> tokenKindCounts = {};
+
+            Statistics::add(Statistic::LexerTokens, tokens.size());
+
+            for (const auto &token : tokens) {
+                tokenKindCounts[(int)token.kind]++;
+            }
+
+            // Token kinds have no names, so they are reported by numeric id.
+            for (const auto &[tokenKind, count] : tokenKindCounts) {
+                Statistics::add("lexer", "tokens.kind-" + std::to_string(tokenKind), count);
+            }
+        }
+
+        if (this->options.diagnosticsOnly) {
+            return tokens;
+        }
+
+        std::stringstream output = std::stringstream();
+
+        output
+            << this->coat(
                 "--- Lexer: " + std::to_string(tokens.size()) + " token(s) ---",
                 ColorKind::ForegroundGreen
             )
@@ -50,16 +108,18 @@ namespace ilc {
         for (auto &token : tokens) {
             // TODO: Only do if specified by option 'trim'.
             if (counter == 10) {
-                std::cout << ConsoleColor::coat("... trimmed ...", ColorKind::ForegroundGray)
+                output << this->coat("... trimmed ...", ColorKind::ForegroundGray)
                     << std::endl;
 
                 break;
             }
 
-            std::cout << token << std::endl;
+            output << token << std::endl;
             counter++;
         }
 
+        this->print(output.str());
+
         return tokens;
     }
 
@@ -77,13 +137,18 @@ namespace ilc {
         this->tokenStream = tokenStream;
 
         try {
+            std::optional<PerfPhase> perfPhase = std::make_optional<PerfPhase>("parse");
             ionlang::AstPtrResult<ionlang::Module> moduleResult = parser.parseModule();
 
+            // Diagnostics are printed outside of the phase.
+            perfPhase.reset();
+
             // TODO: Improve if block?
             if (ionlang::util::hasValue(moduleResult)) {
                 // TODO: What if multiple top-level, in-line constructs are parsed? (Additional note below).
-                std::cout << ConsoleColor::coat("--- Parser ---", ColorKind::ForegroundGreen)
-                    << std::endl;
+                if (!this->options.diagnosticsOnly) {
+                    this->print(this->coat("--- Parser ---", ColorKind::ForegroundGreen) + "\n");
+                }
 
                 return ionlang::util::getResultValue(moduleResult);
             }
@@ -100,8 +165,7 @@ namespace ilc {
 
             // TODO: Check for null ->make().
             if (printResult.first.has_value()) {
-                std::cout << *printResult.first;
-                std::cout.flush();
+                this->print(*printResult.first);
             }
             else {
                 log::error("Could not create stack-trace");
@@ -115,7 +179,7 @@ namespace ilc {
         return std::nullopt;
     }
 
-    std::optional<std::vector<llvm::Module *>> Driver::lowerToLlvmIr(
+    ionshared::OptPtr<ionir::Module> Driver::analyze(
         ionshared::Ptr<ionlang::Module> module,
         ionshared::Ptr<DiagnosticVector> diagnostics
     ) {
@@ -136,27 +200,38 @@ namespace ilc {
 
             // Register all passes to be used by the pass manager.
             // TODO: Create and implement IonLangLogger pass.
-            if (cli::options.passes.contains(cli::PassKind::IonLangLogger)) {
-                ionLangPassManager.registerPass(std::make_shared<IonLangLoggerPass>(passContext));
+            if (this->options.passes.contains(cli::PassKind::IonLangLogger)) {
+                ionLangPassManager.registerPass(std::make_shared<IonLangLoggerPass>(
+                    passContext,
+                    [this](const std::string &text) { this->print(text); }
+                ));
             }
 
-            if (cli::options.passes.contains(cli::PassKind::MacroExpansion)) {
+            if (this->options.passes.contains(cli::PassKind::MacroExpansion)) {
                 ionLangPassManager.registerPass(std::make_shared<ionlang::MacroExpansionPass>(passContext));
             }
 
-//            if (cli::options.passes.contains(cli::PassKind::NameResolution)) {
+//            if (this->options.passes.contains(cli::PassKind::NameResolution)) {
                 ionLangPassManager.registerPass(std::make_shared<ionlang::NameResolutionPass>(passContext));
 //            }
 
             // Execute the pass manager against the parser's resulting AST.
-            ionLangPassManager.run(ionLangAst);
+            {
+                PerfPhase perfPhase = PerfPhase("ionlang-passes");
+
+                ionLangPassManager.run(ionLangAst);
+            }
 
             // TODO: CRITICAL: Should be used with the PassManager instance, as a normal pass instead of manually invoking the visit functions.
-            ionlang::IonIrLoweringPass ionIrLoweringPass = ionlang::IonIrLoweringPass(passContext);
+            TimedIonIrLoweringPass ionIrLoweringPass = TimedIonIrLoweringPass(passContext);
 
             // TODO: What if multiple top-level constructs are defined in-line? Use ionir::Driver (finish it first) and use its resulting Ast. (Additional note above).
             // Visit the parsed module construct.
-            ionIrLoweringPass.visitModule(module);
+            {
+                PerfPhase perfPhase = PerfPhase("ionir-lowering");
+
+                ionIrLoweringPass.visitModule(module);
+            }
 
             ionshared::OptPtr<ionir::Module> ionIrModuleBuffer = ionIrLoweringPass.getModuleBuffer();
 
@@ -168,23 +243,93 @@ namespace ilc {
                 *ionIrModuleBuffer
             };
 
-            ionir::PassManager ionirPassManager = ionir::PassManager();
+            /**
+             * The analysis passes below only read the AST and report
+             * diagnostics, which allows them to run concurrently. Type and
+             * borrow checking additionally inspect each function on its
+             * own, and are split across the functions of the module.
+             */
+            PassScheduler passScheduler = PassScheduler(this->options.jobs);
 
             // Register passes.
-            if (cli::options.passes.contains(cli::PassKind::EntryPointCheck)) {
-                ionirPassManager.registerPass(std::make_shared<ionir::EntryPointCheckPass>(passContext));
+            if (this->options.passes.contains(cli::PassKind::EntryPointCheck)) {
+                passScheduler.registerPass(ScheduledPass{
+                    "entry-point-check",
+
+                    [](ionshared::Ptr<ionshared::PassContext> context) {
+                        return std::make_shared<ionir::EntryPointCheckPass>(context);
+                    },
+
+                    {PassResource::Ast}
+                });
+            }
+
+            if (this->options.passes.contains(cli::PassKind::TypeChecking)) {
+                passScheduler.registerPass(ScheduledPass{
+                    "type-check",
+
+                    [](ionshared::Ptr<ionshared::PassContext> context) {
+                        return std::make_shared<ionir::TypeCheckPass>(context);
+                    },
+
+                    {PassResource::Ast, PassResource::SymbolTable, PassResource::Types},
+                    {},
+                    true
+                });
             }
 
-            if (cli::options.passes.contains(cli::PassKind::TypeChecking)) {
-                ionirPassManager.registerPass(std::make_shared<ionir::TypeCheckPass>(passContext));
+            if (this->options.passes.contains(cli::PassKind::BorrowCheck)) {
+                passScheduler.registerPass(ScheduledPass{
+                    "borrow-check",
+
+                    [](ionshared::Ptr<ionshared::PassContext> context) {
+                        return std::make_shared<ionir::BorrowCheckPass>(context);
+                    },
+
+                    {PassResource::Ast, PassResource::SymbolTable},
+                    {},
+                    true
+                });
             }
 
-            if (cli::options.passes.contains(cli::PassKind::BorrowCheck)) {
-                ionirPassManager.registerPass(std::make_shared<ionir::BorrowCheckPass>(passContext));
+            // Run the scheduled passes on the IonIR AST.
+            {
+                PerfPhase perfPhase = PerfPhase("ionir-passes");
+
+                passScheduler.run(ionIrAst, diagnostics);
             }
 
-            // Run the pass manager on the IonIR AST.
-            ionirPassManager.run(ionIrAst);
+            if (Statistics::isEnabled()) {
+                AstTraceStatistics ionLangStatistics =
+                    AstTracer<ionlang::Construct>(llvm::nulls(), false).trace(module);
+
+                AstTraceStatistics ionIrStatistics =
+                    AstTracer<ionir::Construct>(llvm::nulls(), false).trace(*ionIrModuleBuffer);
+
+                for (const auto &[kindName, count] : ionLangStatistics.nodeCountsByKind) {
+                    Statistics::add("ionlang", "constructs." + kindName, count);
+                }
+
+                for (const auto &[kindName, count] : ionIrStatistics.nodeCountsByKind) {
+                    Statistics::add("ionir", "constructs." + kindName, count);
+                }
+
+                auto findIonIrCount = [&](ionir::ConstructKind constructKind) -> uint64_t {
+                    std::optional<std::string> kindName = ionir::Const::getConstructKindName(constructKind);
+
+                    return kindName.has_value() && ionIrStatistics.nodeCountsByKind.contains(*kindName)
+                        ? ionIrStatistics.nodeCountsByKind.at(*kindName)
+                        : 0;
+                };
+
+                Statistics::add(Statistic::IonIrFunctions, findIonIrCount(ionir::ConstructKind::Function));
+                Statistics::add(Statistic::IonIrBasicBlocks, findIonIrCount(ionir::ConstructKind::BasicBlock));
+                Statistics::add(Statistic::IonIrInstructions, findIonIrCount(ionir::ConstructKind::Instruction));
+
+                for (const auto &diagnostic : diagnostics->unwrap()) {
+                    Statistics::add("diagnostics", DiagnosticPrinter::findDiagnosticTypeText(diagnostic.type));
+                }
+            }
 
             DiagnosticPrinter diagnosticPrinter = DiagnosticPrinter(DiagnosticPrinterOpts{
                 this->input,
@@ -194,32 +339,153 @@ namespace ilc {
             DiagnosticPrinterResult printResult =
                 diagnosticPrinter.createDiagnosticStackTrace(diagnostics);
 
+            if (!diagnostics->isEmpty() && printResult.first.has_value()) {
+                this->print(*printResult.first);
+            }
+
             // TODO: Blocking multi-modules?
             if (printResult.second > 0) {
-                std::cout << " --- LLVM code-generation: Error(s) encountered ---" << std::endl;
+                this->print(" --- Semantic analysis: Error(s) encountered ---\n");
 
                 return std::nullopt;
             }
 
-            // TODO: Where should optimization passes occur? Before or after type-checking?
-//            ionirPassManager.registerPass(std::make_shared<ionir::DeadCodeEliminationPass>());
+            return *ionIrModuleBuffer;
+        }
+        catch (std::exception &exception) {
+            log::error("Semantic analysis: " + std::string(exception.what()));
+            this->tryThrow(exception);
+        }
+
+        return std::nullopt;
+    }
+
+    void Driver::optimizeIonIr(
+        ionshared::Ptr<ionir::Module> module,
+        ionshared::Ptr<DiagnosticVector> diagnostics
+    ) {
+        unsigned optimizationLevel = TargetSetup::findOptimizationLevel(this->options);
+
+        if (optimizationLevel == 0) {
+            return;
+        }
+
+        std::optional<AstTraceStatistics> statisticsBefore = std::nullopt;
+
+        if (Statistics::isEnabled()) {
+            statisticsBefore = AstTracer<ionir::Construct>(llvm::nulls(), false).trace(module);
+        }
+
+        ionir::Ast ionIrAst = {
+            module
+        };
+
+        /**
+         * Runs after the analysis passes, so that dead code is still
+         * checked. Folded branches leave blocks unreachable, whose removal
+         * may in turn leave functions without callers.
+         */
+        PassScheduler passScheduler = PassScheduler(this->options.jobs);
+
+        passScheduler.registerPass(ScheduledPass{
+            "constant-folding",
+
+            [](ionshared::Ptr<ionshared::PassContext> context) {
+                return std::make_shared<IonIrConstantFoldingPass>(context);
+            },
+
+            {PassResource::Ast},
+            {PassResource::Ast},
+            true
+        });
+
+        passScheduler.registerPass(ScheduledPass{
+            "unreachable-block-removal",
+
+            [](ionshared::Ptr<ionshared::PassContext> context) {
+                return std::make_shared<IonIrUnreachableBlockRemovalPass>(context);
+            },
+
+            {PassResource::Ast, PassResource::SymbolTable},
+            {PassResource::Ast, PassResource::SymbolTable},
+            true
+        });
+
+        passScheduler.registerPass(ScheduledPass{
+            "dead-code-elimination",
+
+            [](ionshared::Ptr<ionshared::PassContext> context) {
+                return std::make_shared<CountedDeadCodeEliminationPass>(context);
+            },
+
+            {PassResource::Ast, PassResource::SymbolTable},
+            {PassResource::Ast, PassResource::SymbolTable}
+        });
+
+        /**
+         * Assumes that the module defining the entry point is the root of
+         * the program, so its other functions are not called from elsewhere.
+         */
+        if (optimizationLevel >= 2) {
+            passScheduler.registerPass(ScheduledPass{
+                "dead-function-stripping",
+
+                [](ionshared::Ptr<ionshared::PassContext> context) {
+                    return std::make_shared<IonIrDeadFunctionStrippingPass>(context);
+                },
+
+                {PassResource::Ast, PassResource::SymbolTable},
+                {PassResource::Ast, PassResource::SymbolTable}
+            });
+        }
+
+        {
+            PerfPhase perfPhase = PerfPhase("ionir-optimization");
+
+            passScheduler.run(ionIrAst, diagnostics);
+        }
+
+        if (statisticsBefore.has_value()) {
+            AstTraceStatistics statisticsAfter =
+                AstTracer<ionir::Construct>(llvm::nulls(), false).trace(module);
+
+            for (const auto &[kindName, count] : statisticsBefore->nodeCountsByKind) {
+                size_t remaining = statisticsAfter.nodeCountsByKind[kindName];
+
+                if (count > remaining) {
+                    Statistics::add("ionir-optimization", "constructs-removed." + kindName, count - remaining);
+                }
+            }
+        }
+    }
+
+    std::optional<std::vector<llvm::Module *>> Driver::lowerToLlvmIr(
+        ionshared::Ptr<ionir::Module> module,
+        ionshared::Ptr<DiagnosticVector> diagnostics
+    ) {
+        try {
+            ionshared::Ptr<ionshared::PassContext> passContext =
+                std::make_shared<ionshared::PassContext>(diagnostics);
+
+            this->optimizeIonIr(module, diagnostics);
 
             // Now, make the ionir::LlvmCodegenPass.
-            ionir::LlvmCodegenPass ionIrLlvmCodegenPass = ionir::LlvmCodegenPass(passContext);
+            TimedLlvmCodegenPass ionIrLlvmCodegenPass = TimedLlvmCodegenPass(passContext);
 
-            // Visit the resulting IonIR module buffer from the IonLang codegen pass.
-            ionIrLlvmCodegenPass.visitModule(*ionIrModuleBuffer);
+            // Visit the resulting IonIR module from the IonLang codegen pass.
+            {
+                PerfPhase perfPhase = PerfPhase("llvm-lowering");
+
+                ionIrLlvmCodegenPass.visitModule(module);
+            }
 
             std::map<std::string, llvm::Module *> modules = ionIrLlvmCodegenPass.getModules()->unwrap();
 
             if (modules.empty()) {
-                std::cout
-                    << ConsoleColor::coat(
-                        "--- LLVM code-generation contained no modules ---",
-                        ColorKind::ForegroundGreen
-                    )
-
-                    << std::endl;
+                this->print(this->coat(
+                    "--- LLVM code-generation contained no modules ---",
+                    ColorKind::ForegroundGreen
+                ) + "\n");
 
                 return std::nullopt;
             }
@@ -228,17 +494,20 @@ namespace ilc {
 
             // Display the resulting code of all the modules.
             for (const auto &[key, value] : modules) {
-                std::cout
-                    << ConsoleColor::coat(
-                        "--- LLVM code-generation: " + key + " ---",
-                        ColorKind::ForegroundGreen
-                    )
+                if (!this->options.diagnosticsOnly) {
+                    std::string irText = "";
+                    llvm::raw_string_ostream irStream = llvm::raw_string_ostream(irText);
 
-                    << std::endl;
+                    value->print(irStream, nullptr);
+                    irStream.flush();
 
-                ionshared::LlvmModule llvmModule = ionshared::LlvmModule(value);
+                    this->print(
+                        this->coat("--- LLVM code-generation: " + key + " ---", ColorKind::ForegroundGreen)
+                            + "\n"
+                            + irText
+                    );
+                }
 
-                llvmModule.printIr();
                 result.push_back(value);
             }
 
@@ -252,58 +521,71 @@ namespace ilc {
         return std::nullopt;
     }
 
-    bool Driver::makeObjectCode(llvm::Triple targetTriple, llvm::Module *module) {
-        // Initialize targets for emitting object code.
-        InitializeAllTargetInfos();
-        InitializeAllTargets();
-        InitializeAllTargetMCs();
-        InitializeAllAsmParsers();
-        InitializeAllAsmPrinters();
+    void Driver::optimize(llvm::TargetMachine *targetMachine, llvm::Module *module) {
+        PerfPhase perfPhase = PerfPhase("llvm-optimization");
+        std::optional<FunctionTimingPassGate> functionTimingPassGate = std::nullopt;
+        llvm::PassManagerBuilder passManagerBuilder = llvm::PassManagerBuilder();
+        llvm::legacy::PassManager modulePassManager;
+        llvm::legacy::FunctionPassManager functionPassManager = llvm::legacy::FunctionPassManager(module);
 
-        std::string error;
+        passManagerBuilder.OptLevel = TargetSetup::findOptimizationLevel(this->options);
+        passManagerBuilder.SizeLevel = TargetSetup::findSizeLevel(this->options);
 
-        const llvm::Target *target = llvm::TargetRegistry::lookupTarget(
-            targetTriple.getTriple(),
-            error
-        );
+        passManagerBuilder.Inliner = passManagerBuilder.OptLevel > 1
+            ? llvm::createFunctionInliningPass(passManagerBuilder.OptLevel, passManagerBuilder.SizeLevel, false)
+            : llvm::createAlwaysInlinerLegacyPass();
 
         /**
-         * The requested target could not be found. This might occur if
-         * the target registry was not previously initialized, or if a
-         * bogus target triple was provided.
+         * Leave cross-module work to the link-time step; the pre-link
+         * pipelines avoid optimizations which would hinder it.
          */
-        if (!target) {
-            log::error("Could not lookup target: " + error);
+        passManagerBuilder.PrepareForThinLTO = this->options.lto == cli::LtoKind::Thin;
+        passManagerBuilder.PrepareForLTO = this->options.lto == cli::LtoKind::Full;
 
-            return false;
+        /**
+         * Both instrumentation and profile use happen early in the
+         * pipeline, so that the inliner and later passes see the counts.
+         * Profiles are matched by function name, and by a checksum of the
+         * function's control flow, so that counts of functions whose Ion
+         * source changed since profiling are discarded rather than misapplied.
+         */
+        passManagerBuilder.EnablePGOInstrGen = this->options.profileGenerate;
+
+        if (this->options.profileUse.has_value()) {
+            passManagerBuilder.PGOInstrUse = *this->options.profileUse;
         }
 
-        std::string cpuName = llvm::sys::getHostCPUName();
+        passManagerBuilder.LibraryInfo =
+            new llvm::TargetLibraryInfoImpl(llvm::Triple(targetMachine->getTargetTriple()));
 
-        // Build CPU features.
-        SubtargetFeatures subtargetFeatures = SubtargetFeatures();
-        StringMap<bool> hostFeatures = StringMap<bool>();
+        targetMachine->adjustPassManager(passManagerBuilder);
 
-        if (sys::getHostCPUFeatures(hostFeatures)) {
-            for (auto &feature : hostFeatures) {
-                subtargetFeatures.AddFeature(feature.first(), feature.second);
-            }
+        modulePassManager.add(llvm::createTargetTransformInfoWrapperPass(targetMachine->getTargetIRAnalysis()));
+        functionPassManager.add(llvm::createTargetTransformInfoWrapperPass(targetMachine->getTargetIRAnalysis()));
+
+        passManagerBuilder.populateFunctionPassManager(functionPassManager);
+        passManagerBuilder.populateModulePassManager(modulePassManager);
+
+        if (FunctionTimeReport::isEnabled()) {
+            functionTimingPassGate.emplace(module->getContext(), "llvm-optimization");
         }
 
-        std::string cpuFeatures = subtargetFeatures.getString();
-        llvm::TargetOptions targetOptions = llvm::TargetOptions();
+        functionPassManager.doInitialization();
 
-        llvm::Optional<llvm::Reloc::Model> relocationModel =
-            llvm::Optional<llvm::Reloc::Model>();
+        for (auto &function : *module) {
+            functionPassManager.run(function);
+        }
 
-        llvm::TargetMachine *targetMachine = target->createTargetMachine(
-            targetTriple.getTriple(),
-            cpuName,
-            cpuFeatures,
-            targetOptions,
-            relocationModel
-        );
+        functionPassManager.doFinalization();
+        modulePassManager.run(*module);
+    }
 
+    std::unique_ptr<llvm::MemoryBuffer> Driver::makeMachineCode(
+        llvm::TargetMachine *targetMachine,
+        llvm::Module *module,
+        llvm::TargetMachine::CodeGenFileType outputFileType,
+        llvm::MachineModuleInfo *machineModuleInfo
+    ) {
         /**
          * Configure the module's data layout and target triple
          * for optimization benefits (performance). Optimizations
@@ -314,6 +596,116 @@ namespace ilc {
 //        llvmModule->setDataLayout(targetMachine->createDataLayout());
 //        llvmModule->setTargetTriple(targetTriple.getTriple());
 
+        llvm::SmallVector<char, 0> buffer = llvm::SmallVector<char, 0>();
+        llvm::raw_svector_ostream destination = llvm::raw_svector_ostream(buffer);
+
+        llvm::legacy::PassManager passManager;
+
+        // NOTE: Returns true upon failure.
+        bool failed = targetMachine->addPassesToEmitFile(
+            passManager,
+            destination,
+            nullptr,
+            outputFileType,
+            true,
+            machineModuleInfo
+        );
+
+        if (failed) {
+            log::error("LLVM cannot emit this type of file");
+
+            return nullptr;
+        }
+
+        {
+            PerfPhase perfPhase = PerfPhase("llvm-codegen");
+            std::optional<FunctionTimingPassGate> functionTimingPassGate = std::nullopt;
+
+            if (FunctionTimeReport::isEnabled()) {
+                functionTimingPassGate.emplace(module->getContext(), "llvm-codegen");
+            }
+
+            passManager.run(*module);
+        }
+
+        return std::make_unique<llvm::SmallVectorMemoryBuffer>(std::move(buffer));
+    }
+
+    bool Driver::makeObjectCode(
+        llvm::TargetMachine *targetMachine,
+        llvm::Module *module,
+        llvm::MachineModuleInfo *machineModuleInfo
+    ) {
+        this->outputBuffer = this->makeMachineCode(
+            targetMachine,
+            module,
+            llvm::TargetMachine::CodeGenFileType::CGFT_ObjectFile,
+            machineModuleInfo
+        );
+
+        return this->outputBuffer != nullptr;
+    }
+
+    bool Driver::makeIncrementalObjectCode(
+        const llvm::Triple &targetTriple,
+        llvm::TargetMachine *targetMachine,
+        llvm::Module *module
+    ) {
+        std::filesystem::path cacheDirectory = this->options.incrementalCacheDirectory.has_value()
+            ? std::filesystem::path(*this->options.incrementalCacheDirectory)
+            : std::filesystem::path(this->outputFilePath.parent_path()).append(".ilc-cache").append("functions");
+
+        IncrementalCodegen incrementalCodegen = IncrementalCodegen(IncrementalCodegenOpts{
+            cacheDirectory,
+            llvm::utohexstr(llvm::xxHash64(std::filesystem::absolute(this->outputFilePath).string())),
+            TargetSetup::findConfigurationKey(targetTriple, this->options),
+            targetTriple
+        });
+
+        /**
+         * Functions are optimized on their own, so optimizations across
+         * functions (such as inlining) are limited to each function's
+         * own unit. Link-time optimization is the way to recover those.
+         */
+        this->outputBuffer = incrementalCodegen.run(*module, [&](llvm::Module &unitModule) -> std::unique_ptr<llvm::MemoryBuffer> {
+            this->optimize(targetMachine, &unitModule);
+
+            if (!this->makeObjectCode(targetMachine, &unitModule)) {
+                return nullptr;
+            }
+
+            return this->takeOutputBuffer();
+        });
+
+        return this->outputBuffer != nullptr;
+    }
+
+    bool Driver::makeBitcode(llvm::Module *module) {
+        PerfPhase perfPhase = PerfPhase("llvm-bitcode");
+        llvm::SmallVector<char, 0> buffer = llvm::SmallVector<char, 0>();
+        llvm::raw_svector_ostream destination = llvm::raw_svector_ostream(buffer);
+
+        /**
+         * ThinLTO requires a module summary to decide which functions
+         * to import across modules. Full LTO must not be given one, since
+         * LLVM treats summarized modules as ThinLTO modules.
+         */
+        if (this->options.lto == cli::LtoKind::Thin) {
+            llvm::ModuleSummaryIndex summaryIndex = llvm::buildModuleSummaryIndex(*module, nullptr, nullptr);
+
+            llvm::WriteBitcodeToFile(*module, destination, false, &summaryIndex);
+        }
+        else {
+            llvm::WriteBitcodeToFile(*module, destination);
+        }
+
+        this->outputBuffer = std::make_unique<llvm::SmallVectorMemoryBuffer>(std::move(buffer));
+
+        return true;
+    }
+
+    bool Driver::writeOutputBuffer() {
+        PerfPhase perfPhase = PerfPhase("object-emission");
         std::error_code errorCode = std::error_code();
 
         llvm::raw_fd_ostream destination = llvm::raw_fd_ostream(
@@ -328,64 +720,516 @@ namespace ilc {
             return false;
         }
 
-        llvm::legacy::PassManager passManager;
+        destination << this->outputBuffer->getBuffer();
+        destination.flush();
 
-        llvm::TargetMachine::CodeGenFileType outputFileType =
-            llvm::TargetMachine::CodeGenFileType::CGFT_ObjectFile;
+        return true;
+    }
 
-        // NOTE: Returns true upon failure.
-        bool failed = targetMachine->addPassesToEmitFile(
-            passManager,
-            destination,
-            nullptr,
-            outputFileType
+    bool Driver::writeArtifact(const std::string &extension, llvm::StringRef contents) {
+        PerfPhase perfPhase = PerfPhase("artifact-emission");
+        std::filesystem::path artifactFilePath = std::filesystem::path(this->outputFilePath).replace_extension(extension);
+        std::error_code errorCode = std::error_code();
+
+        llvm::raw_fd_ostream destination = llvm::raw_fd_ostream(
+            artifactFilePath.string(),
+            errorCode,
+            extension == ".bc" ? llvm::sys::fs::OF_None : llvm::sys::fs::OF_Text
         );
 
-        if (failed) {
-            log::error("LLVM cannot emit this type of file");
+        if (errorCode) {
+            log::error("Could not open output file '" + artifactFilePath.string() + "': " + errorCode.message());
 
             return false;
         }
 
-        passManager.run(*module);
+        destination << contents;
         destination.flush();
 
+        if (Statistics::isEnabled()) {
+            Statistics::add("artifacts", extension.substr(1) + "-bytes-emitted", contents.size());
+        }
+
+        return true;
+    }
+
+    bool Driver::writeModuleArtifacts(llvm::Module *module) {
+        if (this->options.emit.contains(cli::EmitKind::LlvmIr)) {
+            std::string text = std::string();
+            llvm::raw_string_ostream textStream = llvm::raw_string_ostream(text);
+
+            module->print(textStream, nullptr);
+            textStream.flush();
+
+            if (!this->writeArtifact(".ll", text)) {
+                return false;
+            }
+        }
+
+        // Bitcode for the link-time step is already in the output buffer, summary included.
+        if (this->options.emit.contains(cli::EmitKind::LlvmBitcode) && this->options.lto == cli::LtoKind::None) {
+            llvm::SmallVector<char, 0> buffer = llvm::SmallVector<char, 0>();
+            llvm::raw_svector_ostream destination = llvm::raw_svector_ostream(buffer);
+
+            llvm::WriteBitcodeToFile(*module, destination);
+
+            if (!this->writeArtifact(".bc", llvm::StringRef(buffer.data(), buffer.size()))) {
+                return false;
+            }
+        }
+
         return true;
     }
 
+    std::string Driver::coat(const std::string &text, ColorKind color) const {
+        return ConsoleColor::coat(text, color, !this->options.noColor);
+    }
+
+    void Driver::print(const std::string &text) {
+        if (this->diagnosticSink != nullptr) {
+            this->diagnosticSink(text);
+
+            return;
+        }
+
+        std::cout << text;
+        std::cout.flush();
+    }
+
+    void Driver::reset(std::filesystem::path outputFilePath, std::string input) {
+        this->outputFilePath = std::move(outputFilePath);
+        this->input = std::move(input);
+        this->tokenStream = std::nullopt;
+        this->outputBuffer = nullptr;
+        this->functionSizes.clear();
+
+        // The module must be destroyed before the context owning it.
+        this->cachedModule = nullptr;
+        this->cachedModuleContext = nullptr;
+    }
+
     void Driver::tryThrow(std::exception exception) {
-        if (cli::options.jitThrow) {
+        if (this->options.jitThrow) {
             throw exception;
         }
     }
 
+    Driver::Driver(cli::Options options, DiagnosticSink diagnosticSink) :
+        options(std::move(options)),
+        diagnosticSink(std::move(diagnosticSink)) {
+        //
+    }
+
+    bool Driver::emit(
+        const llvm::Triple &targetTriple,
+        llvm::Module *llvmModule,
+        const std::optional<RemarksOpts> &remarksOpts
+    ) {
+        std::unique_ptr<llvm::TargetMachine> targetMachine =
+            TargetSetup::createTargetMachine(targetTriple, this->options);
+
+        if (targetMachine == nullptr) {
+            return false;
+        }
+
+        // Versions are created before optimization, so that each is optimized for its own features.
+        if (!this->options.multiversionFunctions.empty()) {
+            bool multiversioned = FunctionMultiversioning::apply(*llvmModule, targetTriple, FunctionMultiversioningOpts{
+                this->options.multiversionFunctions,
+                this->options.multiversionTargets
+            });
+
+            if (!multiversioned) {
+                return false;
+            }
+        }
+
+        std::unique_ptr<llvm::ToolOutputFile> remarksFile = nullptr;
+
+        if (remarksOpts.has_value()) {
+            remarksFile = Remarks::begin(llvmModule->getContext(), *remarksOpts);
+
+            if (remarksFile == nullptr) {
+                return false;
+            }
+        }
+
+        if (FunctionTimeReport::isEnabled()) {
+            for (const auto &function : *llvmModule) {
+                if (!function.isDeclaration()) {
+                    FunctionTimeReport::setInstructionCount(function.getName().str(), function.getInstructionCount());
+                }
+            }
+        }
+
+        if (Statistics::isEnabled()) {
+            Statistics::add(Statistic::LlvmIrFunctions, llvmModule->size());
+
+            for (const auto &function : *llvmModule) {
+                Statistics::add(Statistic::LlvmIrBasicBlocks, function.size());
+                Statistics::add(Statistic::LlvmIrInstructions, function.getInstructionCount());
+            }
+        }
+
+        std::optional<SizeReportCollector> sizeReportCollector = std::nullopt;
+
+        if (SizeReport::isEnabled()) {
+            sizeReportCollector.emplace(llvmModule->getContext());
+        }
+
+        bool emitsModuleArtifacts = this->options.emit.contains(cli::EmitKind::Assembly)
+            || this->options.emit.contains(cli::EmitKind::LlvmIr)
+            || this->options.emit.contains(cli::EmitKind::LlvmBitcode);
+
+        // Object code is needed on disk, or in memory for linking, archiving or embedders.
+        bool needsObjectCode = this->options.emit.contains(cli::EmitKind::Object)
+            || this->options.emit.contains(cli::EmitKind::Executable)
+            || this->options.emit.contains(cli::EmitKind::SharedObject)
+            || this->options.emit.contains(cli::EmitKind::Archive)
+            || !emitsModuleArtifacts;
+
+        bool success;
+
+        // Link-time optimization defers code generation to the link-time step.
+        if (this->options.lto != cli::LtoKind::None) {
+            if (this->options.emit.contains(cli::EmitKind::Assembly)) {
+                log::warning("Assembly is unavailable when using link-time optimization; it is generated at link time");
+            }
+
+            this->optimize(targetMachine.get(), llvmModule);
+            success = this->makeBitcode(llvmModule) && this->writeModuleArtifacts(llvmModule);
+
+            if (success && this->options.emit.contains(cli::EmitKind::LlvmBitcode)) {
+                success = this->writeArtifact(".bc", this->outputBuffer->getBuffer());
+            }
+        }
+        // Per-function units are never whole optimized modules, from which artifacts are written.
+        else if (this->options.incremental && IncrementalCodegen::isAvailable() && !emitsModuleArtifacts) {
+            success = this->makeIncrementalObjectCode(targetTriple, targetMachine.get(), llvmModule);
+        }
+        else {
+            if (this->options.incremental && !emitsModuleArtifacts) {
+                log::warning("Incremental code generation is unavailable; ilc was built without LLD");
+            }
+
+            this->optimize(targetMachine.get(), llvmModule);
+            success = this->writeModuleArtifacts(llvmModule);
+
+            /**
+             * Code generation alters the module, and LLVM's pipeline emits
+             * a single file type per run. Assembly is therefore generated
+             * from a copy of the optimized module when object code is
+             * needed as well; the IR pipeline still only runs once.
+             */
+            if (success && this->options.emit.contains(cli::EmitKind::Assembly)) {
+                std::unique_ptr<llvm::Module> assemblyModule = needsObjectCode
+                    ? llvm::CloneModule(*llvmModule)
+                    : nullptr;
+
+                std::unique_ptr<llvm::MemoryBuffer> assembly = this->makeMachineCode(
+                    targetMachine.get(),
+                    assemblyModule != nullptr ? assemblyModule.get() : llvmModule,
+                    llvm::TargetMachine::CodeGenFileType::CGFT_AssemblyFile
+                );
+
+                success = assembly != nullptr && this->writeArtifact(".s", assembly->getBuffer());
+            }
+
+            if (success && needsObjectCode) {
+                success = this->makeObjectCode(targetMachine.get(), llvmModule);
+            }
+        }
+
+        if (remarksFile != nullptr) {
+            Remarks::finish(llvmModule->getContext(), std::move(remarksFile));
+        }
+
+        if (!success) {
+            return false;
+        }
+
+        if (this->outputBuffer != nullptr) {
+            Statistics::add(Statistic::CodegenBytesEmitted, this->outputBuffer->getBufferSize());
+        }
+
+        // Bitcode for the link-time step holds no machine code to measure.
+        if (sizeReportCollector.has_value()) {
+            this->functionSizes = sizeReportCollector->collect(
+                *llvmModule,
+                this->options.lto == cli::LtoKind::None ? this->outputBuffer.get() : nullptr
+            );
+        }
+
+        /**
+         * Under link-time optimization, the object file is the bitcode
+         * artifact itself when both share a path, in which case it was
+         * already written.
+         */
+        bool isObjectWritten = this->options.lto != cli::LtoKind::None
+            && this->options.emit.contains(cli::EmitKind::LlvmBitcode)
+            && std::filesystem::path(this->outputFilePath).replace_extension(".bc") == this->outputFilePath;
+
+        // Otherwise, the output is only kept in memory for the link step.
+        if (this->options.emit.contains(cli::EmitKind::Object) && this->outputBuffer != nullptr && !isObjectWritten) {
+            return this->writeOutputBuffer();
+        }
+
+        return true;
+    }
+
     bool Driver::run(
         llvm::Triple targetTriple,
         std::filesystem::path outputFilePath,
-        std::string input
+        std::string input,
+        std::optional<RemarksOpts> remarksOpts
     ) {
-        this->outputFilePath = outputFilePath;
-        this->input = input;
+        this->reset(outputFilePath, input);
+
+        std::filesystem::path astCacheFilePath = AstCache::makePath(outputFilePath);
+        std::string contentHash = AstCache::findContentHash(
+            input,
+            targetTriple,
+            this->options.passes,
+            TargetSetup::findOptimizationLevel(this->options) > 0
+        );
 
-        std::vector<ionlang::Token> tokens = this->lex();
+        bool usesAstCache = !this->options.noAstCache && this->options.phaseLevel >= cli::PhaseLevel::Semantic;
+        llvm::Module *llvmModule = nullptr;
 
-        ionshared::Ptr<DiagnosticVector> diagnostics =
-            std::make_shared<DiagnosticVector>();
+        if (usesAstCache) {
+            this->cachedModuleContext = std::make_unique<llvm::LLVMContext>();
+            this->cachedModule = AstCache::load(astCacheFilePath, contentHash, *this->cachedModuleContext);
+
+            if (this->cachedModule != nullptr) {
+                log::verbose("Using cached AST '" + astCacheFilePath.string() + "'");
+
+                // Only error-free results are cached, so there is nothing left to report.
+                if (this->options.phaseLevel == cli::PhaseLevel::Semantic) {
+                    return true;
+                }
+
+                llvmModule = this->cachedModule.get();
+            }
+        }
+
+        if (llvmModule == nullptr) {
+            std::vector<ionlang::Token> tokens = this->lex();
+
+            if (this->options.phaseLevel == cli::PhaseLevel::Lexing) {
+                return true;
+            }
+
+            ionshared::Ptr<DiagnosticVector> diagnostics =
+                std::make_shared<DiagnosticVector>();
+
+            ionshared::OptPtr<ionlang::Module> ionLangModules = this->parse(tokens, diagnostics);
+
+            if (!ionshared::util::hasValue(ionLangModules)) {
+                return false;
+            }
+
+            // Checking stops before anything LLVM-related is initialized.
+            if (this->options.phaseLevel == cli::PhaseLevel::Parsing) {
+                return true;
+            }
+
+            ionshared::OptPtr<ionir::Module> ionIrModule = this->analyze(*ionLangModules, diagnostics);
+
+            if (!ionshared::util::hasValue(ionIrModule)) {
+                return false;
+            }
+            else if (this->options.phaseLevel == cli::PhaseLevel::Semantic) {
+                return true;
+            }
+
+            std::optional<std::vector<llvm::Module *>> llvmModules =
+                this->lowerToLlvmIr(*ionIrModule, diagnostics);
+
+            if (!llvmModules.has_value() || llvmModules->empty()) {
+                return false;
+            }
+
+            // TODO: Processing only first module until implemented support for multiple (consider multiple modules inside a single file).
+            llvmModule = llvmModules.value()[0];
+
+            /**
+             * Results with warnings are not cached, so that a cache hit
+             * always reports exactly the same diagnostics as a full run.
+             * The module must be cached before optimization modifies it.
+             */
+            if (usesAstCache && diagnostics->isEmpty() && !AstCache::store(astCacheFilePath, contentHash, *llvmModule)) {
+                log::warning("Could not write AST cache '" + astCacheFilePath.string() + "'");
+            }
+        }
+
+        return this->emit(targetTriple, llvmModule, remarksOpts);
+    }
+
+    bool Driver::runBackend(
+        llvm::Triple targetTriple,
+        std::filesystem::path outputFilePath,
+        std::string input,
+        InputKind inputKind,
+        std::optional<RemarksOpts> remarksOpts
+    ) {
+        this->reset(outputFilePath, input);
+        this->cachedModuleContext = std::make_unique<llvm::LLVMContext>();
+
+        std::unique_ptr<llvm::MemoryBuffer> inputBuffer =
+            llvm::MemoryBuffer::getMemBuffer(this->input, outputFilePath.string(), false);
+
+        std::unique_ptr<llvm::MIRParser> mirParser = nullptr;
+
+        {
+            PerfPhase perfPhase = PerfPhase("parse");
+
+            if (inputKind == InputKind::Mir) {
+                mirParser = llvm::createMIRParser(std::move(inputBuffer), *this->cachedModuleContext);
+
+                if (mirParser != nullptr) {
+                    this->cachedModule = mirParser->parseIRModule();
+                }
+            }
+            else {
+                llvm::SMDiagnostic diagnostic = llvm::SMDiagnostic();
+
+                // Handles both textual IR and bitcode.
+                this->cachedModule = llvm::parseIR(inputBuffer->getMemBufferRef(), diagnostic, *this->cachedModuleContext);
+
+                if (this->cachedModule == nullptr) {
+                    std::string message;
+                    llvm::raw_string_ostream messageStream = llvm::raw_string_ostream(message);
+
+                    diagnostic.print(nullptr, messageStream, false);
+                    log::error("Could not parse LLVM input: " + messageStream.str());
+                }
+            }
+        }
+
+        if (this->cachedModule == nullptr) {
+            return false;
+        }
+        else if (this->options.phaseLevel < cli::PhaseLevel::CodeGeneration) {
+            return true;
+        }
+
+        // Inputs without a target triple are compiled for the requested one.
+        if (this->cachedModule->getTargetTriple().empty()) {
+            this->cachedModule->setTargetTriple(targetTriple.getTriple());
+        }
+
+        if (inputKind != InputKind::Mir) {
+            return this->emit(targetTriple, this->cachedModule.get(), remarksOpts);
+        }
 
-        ionshared::OptPtr<ionlang::Module> ionLangModules = this->parse(tokens, diagnostics);
+        /**
+         * Machine functions can only be emitted as object code, so MIR
+         * cannot take part in link-time optimization, and the IR passes
+         * must not run over the IR which they refer to.
+         */
+        if (this->options.lto != cli::LtoKind::None) {
+            log::error("MIR inputs cannot be used with link-time optimization");
+
+            return false;
+        }
+
+        std::unique_ptr<llvm::TargetMachine> targetMachine =
+            TargetSetup::createTargetMachine(targetTriple, this->options);
 
-        if (!ionshared::util::hasValue(ionLangModules)) {
+        if (targetMachine == nullptr) {
             return false;
         }
 
-        std::optional<std::vector<llvm::Module *>> llvmModules =
-            this->lowerToLlvmIr(*ionLangModules, diagnostics);
+        this->cachedModule->setDataLayout(targetMachine->createDataLayout());
+
+        // Owned by the code generation pass manager once handed over.
+        std::unique_ptr<llvm::MachineModuleInfo> machineModuleInfo = std::make_unique<llvm::MachineModuleInfo>(
+            static_cast<llvm::LLVMTargetMachine *>(targetMachine.get())
+        );
+
+        {
+            PerfPhase perfPhase = PerfPhase("parse");
+
+            // NOTE: Returns true upon failure.
+            if (mirParser->parseMachineFunctions(*this->cachedModule, *machineModuleInfo)) {
+                return false;
+            }
+        }
+
+        /**
+         * The parser records the properties given by the MIR, which the
+         * code generator respects by skipping the corresponding passes.
+         * Only GlobalISel records selection though, so functions written
+         * after SelectionDAG's are marked as selected here, unless they
+         * still contain generic instructions.
+         */
+        for (const auto &function : *this->cachedModule) {
+            llvm::MachineFunction *machineFunction = machineModuleInfo->getMachineFunction(function);
+
+            if (machineFunction == nullptr
+                || machineFunction->getProperties().hasProperty(llvm::MachineFunctionProperties::Property::Selected)) {
+                continue;
+            }
+
+            bool isGeneric = llvm::any_of(*machineFunction, [](const llvm::MachineBasicBlock &basicBlock) {
+                return llvm::any_of(basicBlock, [](const llvm::MachineInstr &instruction) {
+                    return llvm::isPreISelGenericOpcode(instruction.getOpcode());
+                });
+            });
+
+            if (!isGeneric) {
+                machineFunction->getProperties().set(llvm::MachineFunctionProperties::Property::Selected);
+            }
+        }
+
+        std::optional<SizeReportCollector> sizeReportCollector = std::nullopt;
 
-        if (!llvmModules.has_value() || llvmModules->empty()) {
+        if (SizeReport::isEnabled()) {
+            sizeReportCollector.emplace(this->cachedModule->getContext());
+        }
+
+        if (!this->makeObjectCode(targetMachine.get(), this->cachedModule.get(), machineModuleInfo.release())) {
             return false;
         }
 
-        // TODO: Processing only first module until implemented support for multiple (consider multiple modules inside a single file).
-        return this->makeObjectCode(targetTriple, llvmModules.value()[0]);
+        Statistics::add(Statistic::CodegenBytesEmitted, this->outputBuffer->getBufferSize());
+
+        if (sizeReportCollector.has_value()) {
+            this->functionSizes = sizeReportCollector->collect(*this->cachedModule, this->outputBuffer.get());
+        }
+
+        if (this->options.emit.contains(cli::EmitKind::Object)) {
+            return this->writeOutputBuffer();
+        }
+
+        return true;
+    }
+
+    std::optional<DriverFrontendResult> Driver::runFrontend(std::string input) {
+        this->reset(std::filesystem::path(), input);
+
+        std::vector<ionlang::Token> tokens = this->lex();
+
+        ionshared::Ptr<DiagnosticVector> diagnostics =
+            std::make_shared<DiagnosticVector>();
+
+        ionshared::OptPtr<ionlang::Module> ionLangModule = this->parse(tokens, diagnostics);
+
+        if (!ionshared::util::hasValue(ionLangModule)) {
+            return std::nullopt;
+        }
+
+        return DriverFrontendResult{
+            *ionLangModule,
+            this->analyze(*ionLangModule, diagnostics)
+        };
+    }
+
+    std::unique_ptr<llvm::MemoryBuffer> Driver::takeOutputBuffer() {
+        return std::move(this->outputBuffer);
+    }
+
+    std::vector<FunctionSize> Driver::takeFunctionSizes() {
+        return std::move(this->functionSizes);
     }
 }
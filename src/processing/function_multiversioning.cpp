@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/IR/GlobalIFunc.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/InlineAsm.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <ilc/misc/log.h>
+#include <ilc/processing/function_multiversioning.h>
+
+#define ILC_FUNCTION_MULTIVERSIONING_LEVELS_NAME "ilc.multiversion.levels"
+
+namespace ilc {
+    namespace {
+        /**
+         * A micro-architecture level along with the 'cpuid' bits, and the
+         * state components enabled by the operating system ('xgetbv'),
+         * which its features require.
+         */
+        struct TargetLevel {
+            std::string name;
+
+            std::vector<std::string> features;
+
+            uint32_t leaf1Ecx;
+
+            uint32_t leaf7Ebx;
+
+            uint32_t extendedLeaf1Ecx;
+
+            uint32_t xcr0;
+        };
+
+        // Each level includes everything of the levels before it.
+        const std::vector<TargetLevel> targetLevels = {
+            TargetLevel{
+                "x86-64-v2",
+                {"+cx16", "+popcnt", "+sahf", "+sse3", "+sse4.1", "+sse4.2", "+ssse3"},
+
+                // SSE3, SSSE3, CX16, SSE4.1, SSE4.2, POPCNT.
+                (1u << 0) | (1u << 9) | (1u << 13) | (1u << 19) | (1u << 20) | (1u << 23),
+                0,
+
+                // LAHF/SAHF.
+                1u << 0,
+                0
+            },
+
+            TargetLevel{
+                "x86-64-v3",
+
+                {
+                    "+cx16", "+popcnt", "+sahf", "+sse3", "+sse4.1", "+sse4.2", "+ssse3",
+                    "+avx", "+avx2", "+bmi", "+bmi2", "+f16c", "+fma", "+lzcnt", "+movbe", "+xsave"
+                },
+
+                // The above, and FMA, MOVBE, XSAVE, OSXSAVE, AVX, F16C.
+                (1u << 0) | (1u << 9) | (1u << 13) | (1u << 19) | (1u << 20) | (1u << 23)
+                    | (1u << 12) | (1u << 22) | (1u << 26) | (1u << 27) | (1u << 28) | (1u << 29),
+
+                // BMI, AVX2, BMI2.
+                (1u << 3) | (1u << 5) | (1u << 8),
+
+                // LAHF/SAHF, LZCNT.
+                (1u << 0) | (1u << 5),
+
+                // SSE and AVX state.
+                0x6
+            },
+
+            TargetLevel{
+                "x86-64-v4",
+
+                {
+                    "+cx16", "+popcnt", "+sahf", "+sse3", "+sse4.1", "+sse4.2", "+ssse3",
+                    "+avx", "+avx2", "+bmi", "+bmi2", "+f16c", "+fma", "+lzcnt", "+movbe", "+xsave",
+                    "+avx512f", "+avx512bw", "+avx512cd", "+avx512dq", "+avx512vl"
+                },
+
+                (1u << 0) | (1u << 9) | (1u << 13) | (1u << 19) | (1u << 20) | (1u << 23)
+                    | (1u << 12) | (1u << 22) | (1u << 26) | (1u << 27) | (1u << 28) | (1u << 29),
+
+                // The above, and AVX512F, AVX512DQ, AVX512CD, AVX512BW, AVX512VL.
+                (1u << 3) | (1u << 5) | (1u << 8)
+                    | (1u << 16) | (1u << 17) | (1u << 28) | (1u << 30) | (1u << 31),
+
+                (1u << 0) | (1u << 5),
+
+                // SSE, AVX, and AVX-512 opmask and upper register state.
+                0xe6
+            }
+        };
+
+        const TargetLevel *findTargetLevel(const std::string &targetName) {
+            for (const auto &targetLevel : targetLevels) {
+                if (targetLevel.name == targetName) {
+                    return &targetLevel;
+                }
+            }
+
+            return nullptr;
+        }
+
+        llvm::Value *createCpuid(llvm::IRBuilder<> &builder, uint32_t leaf, unsigned registerIndex) {
+            llvm::Type *int32Type = builder.getInt32Ty();
+            llvm::Type *resultType = llvm::StructType::get(int32Type, int32Type, int32Type, int32Type);
+
+            llvm::InlineAsm *cpuid = llvm::InlineAsm::get(
+                llvm::FunctionType::get(resultType, {int32Type, int32Type}, false),
+                "cpuid",
+                "={ax},={bx},={cx},={dx},{ax},{cx},~{dirflag},~{fpsr},~{flags}",
+                false
+            );
+
+            llvm::Value *result = builder.CreateCall(cpuid, {builder.getInt32(leaf), builder.getInt32(0)});
+
+            return builder.CreateExtractValue(result, registerIndex);
+        }
+
+        llvm::Value *createHasAllBits(llvm::IRBuilder<> &builder, llvm::Value *value, uint32_t mask) {
+            return builder.CreateICmpEQ(
+                builder.CreateAnd(value, builder.getInt32(mask)),
+                builder.getInt32(mask)
+            );
+        }
+
+        /**
+         * Create, or find a previously created, function returning a mask
+         * of the given levels supported by the running CPU, where bit i
+         * stands for the i-th level.
+         */
+        llvm::Function *findLevelsFunction(llvm::Module &module, const std::vector<const TargetLevel *> &levels) {
+            if (llvm::Function *existing = module.getFunction(ILC_FUNCTION_MULTIVERSIONING_LEVELS_NAME)) {
+                return existing;
+            }
+
+            llvm::LLVMContext &context = module.getContext();
+            llvm::Type *int32Type = llvm::Type::getInt32Ty(context);
+
+            llvm::Function *function = llvm::Function::Create(
+                llvm::FunctionType::get(int32Type, false),
+                llvm::GlobalValue::InternalLinkage,
+                ILC_FUNCTION_MULTIVERSIONING_LEVELS_NAME,
+                &module
+            );
+
+            llvm::BasicBlock *entryBlock = llvm::BasicBlock::Create(context, "entry", function);
+            llvm::BasicBlock *xgetbvBlock = llvm::BasicBlock::Create(context, "xgetbv", function);
+            llvm::BasicBlock *levelsBlock = llvm::BasicBlock::Create(context, "levels", function);
+            llvm::IRBuilder<> builder = llvm::IRBuilder<>(entryBlock);
+
+            /**
+             * Leaves beyond the maximum return the data of the highest
+             * one, and must therefore be masked out.
+             */
+            llvm::Value *maxLeaf = createCpuid(builder, 0, 0);
+            llvm::Value *leaf1Ecx = createCpuid(builder, 1, 2);
+
+            llvm::Value *leaf7Ebx = builder.CreateSelect(
+                builder.CreateICmpUGE(maxLeaf, builder.getInt32(7)),
+                createCpuid(builder, 7, 1),
+                builder.getInt32(0)
+            );
+
+            llvm::Value *maxExtendedLeaf = createCpuid(builder, 0x80000000, 0);
+
+            llvm::Value *extendedLeaf1Ecx = builder.CreateSelect(
+                builder.CreateICmpUGE(maxExtendedLeaf, builder.getInt32(0x80000001)),
+                createCpuid(builder, 0x80000001, 2),
+                builder.getInt32(0)
+            );
+
+            // 'xgetbv' faults unless the operating system enabled it (OSXSAVE).
+            builder.CreateCondBr(createHasAllBits(builder, leaf1Ecx, 1u << 27), xgetbvBlock, levelsBlock);
+            builder.SetInsertPoint(xgetbvBlock);
+
+            // Encoded as bytes, since assembling the mnemonic may require the feature.
+            llvm::InlineAsm *xgetbv = llvm::InlineAsm::get(
+                llvm::FunctionType::get(
+                    llvm::StructType::get(int32Type, int32Type),
+                    {int32Type},
+                    false
+                ),
+
+                ".byte 0x0f, 0x01, 0xd0",
+                "={ax},={dx},{cx},~{dirflag},~{fpsr},~{flags}",
+                true
+            );
+
+            llvm::Value *xcr0 = builder.CreateExtractValue(builder.CreateCall(xgetbv, {builder.getInt32(0)}), 0);
+
+            builder.CreateBr(levelsBlock);
+            builder.SetInsertPoint(levelsBlock);
+
+            llvm::PHINode *enabledXcr0 = builder.CreatePHI(int32Type, 2);
+
+            enabledXcr0->addIncoming(builder.getInt32(0), entryBlock);
+            enabledXcr0->addIncoming(xcr0, xgetbvBlock);
+
+            llvm::Value *result = builder.getInt32(0);
+
+            for (size_t i = 0; i < levels.size(); i++) {
+                llvm::Value *isSupported = builder.CreateAnd(
+                    builder.CreateAnd(
+                        createHasAllBits(builder, leaf1Ecx, levels[i]->leaf1Ecx),
+                        createHasAllBits(builder, leaf7Ebx, levels[i]->leaf7Ebx)
+                    ),
+
+                    builder.CreateAnd(
+                        createHasAllBits(builder, extendedLeaf1Ecx, levels[i]->extendedLeaf1Ecx),
+                        createHasAllBits(builder, enabledXcr0, levels[i]->xcr0)
+                    )
+                );
+
+                result = builder.CreateOr(
+                    result,
+                    builder.CreateShl(builder.CreateZExt(isSupported, int32Type), i)
+                );
+            }
+
+            builder.CreateRet(result);
+
+            return function;
+        }
+    }
+
+    std::optional<std::vector<std::string>> FunctionMultiversioning::findTargetFeatures(const std::string &targetName) {
+        const TargetLevel *targetLevel = findTargetLevel(targetName);
+
+        if (targetLevel == nullptr) {
+            return std::nullopt;
+        }
+
+        return targetLevel->features;
+    }
+
+    bool FunctionMultiversioning::isSupported(const llvm::Triple &targetTriple) {
+        return targetTriple.getArch() == llvm::Triple::x86_64 && targetTriple.isOSBinFormatELF();
+    }
+
+    bool FunctionMultiversioning::apply(
+        llvm::Module &module,
+        const llvm::Triple &targetTriple,
+        const FunctionMultiversioningOpts &opts
+    ) {
+        if (!FunctionMultiversioning::isSupported(targetTriple)) {
+            log::error("Function multiversioning is only supported on x86-64 ELF targets");
+
+            return false;
+        }
+
+        std::vector<const TargetLevel *> levels = {};
+
+        for (const auto &targetName : opts.targetNames) {
+            const TargetLevel *targetLevel = findTargetLevel(targetName);
+
+            if (targetLevel == nullptr) {
+                log::error("Unknown multiversioning target '" + targetName + "'; expected x86-64-v2, x86-64-v3 or x86-64-v4");
+
+                return false;
+            }
+            else if (std::find(levels.begin(), levels.end(), targetLevel) == levels.end()) {
+                levels.push_back(targetLevel);
+            }
+        }
+
+        // Ordered from the lowest level up, so that the highest supported one is selected last.
+        std::sort(levels.begin(), levels.end());
+
+        for (const auto &functionName : opts.functionNames) {
+            llvm::Function *function = module.getFunction(functionName);
+
+            if (function == nullptr || function->isDeclaration()) {
+                log::verbose("Function '" + functionName + "' to multiversion is not defined in this module");
+
+                continue;
+            }
+
+            std::vector<llvm::Function *> versions = {};
+
+            for (const auto level : levels) {
+                llvm::ValueToValueMapTy valueMap = llvm::ValueToValueMapTy();
+                llvm::Function *version = llvm::CloneFunction(function, valueMap);
+                std::string features = llvm::join(level->features, ",");
+
+                if (function->hasFnAttribute("target-features")) {
+                    features = function->getFnAttribute("target-features").getValueAsString().str() + "," + features;
+                }
+
+                version->setName(functionName + "." + level->name);
+                version->setLinkage(llvm::GlobalValue::InternalLinkage);
+                version->addFnAttr("target-features", features);
+                versions.push_back(version);
+            }
+
+            llvm::Function *resolver = llvm::Function::Create(
+                llvm::FunctionType::get(function->getType(), false),
+                llvm::GlobalValue::InternalLinkage,
+                functionName + ".resolver",
+                &module
+            );
+
+            function->setName(functionName + ".default");
+
+            llvm::GlobalIFunc *indirectFunction = llvm::GlobalIFunc::create(
+                function->getFunctionType(),
+                function->getAddressSpace(),
+                function->getLinkage(),
+                functionName,
+                resolver,
+                &module
+            );
+
+            indirectFunction->setVisibility(function->getVisibility());
+
+            // Every use, including recursive calls within the versions, is dispatched.
+            function->replaceAllUsesWith(indirectFunction);
+            function->setLinkage(llvm::GlobalValue::InternalLinkage);
+            function->setVisibility(llvm::GlobalValue::DefaultVisibility);
+
+            llvm::IRBuilder<> builder = llvm::IRBuilder<>(
+                llvm::BasicBlock::Create(module.getContext(), "entry", resolver)
+            );
+
+            llvm::Value *supportedLevels = builder.CreateCall(findLevelsFunction(module, levels));
+            llvm::Value *result = function;
+
+            for (size_t i = 0; i < versions.size(); i++) {
+                llvm::Value *isSupported = builder.CreateICmpNE(
+                    builder.CreateAnd(supportedLevels, builder.getInt32(1u << i)),
+                    builder.getInt32(0)
+                );
+
+                result = builder.CreateSelect(isSupported, versions[i], result);
+            }
+
+            builder.CreateRet(result);
+        }
+
+        return true;
+    }
+}
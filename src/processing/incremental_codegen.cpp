@@ -0,0 +1,509 @@
+#include <set>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/Support/CachePruning.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/SHA1.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+#include <ilc/misc/const.h>
+#include <ilc/misc/log.h>
+#include <ilc/processing/linker.h>
+#include <ilc/processing/incremental_codegen.h>
+
+/**
+ * Bump whenever the way keys are computed changes, to invalidate
+ * existing caches.
+ */
+#define ILC_INCREMENTAL_CODEGEN_SCHEMA_VERSION 1
+
+// LLVM's cache pruning only considers files with this prefix.
+#define ILC_INCREMENTAL_CODEGEN_FILE_PREFIX "llvmcache-"
+
+namespace ilc {
+    namespace {
+        void collectReferencedGlobals(
+            const llvm::Value *value,
+            std::set<const llvm::GlobalValue *> &globals,
+            std::set<const llvm::Constant *> &visitedConstants
+        ) {
+            if (auto globalValue = llvm::dyn_cast<llvm::GlobalValue>(value)) {
+                globals.insert(globalValue);
+            }
+            // Globals may be nested within constant expressions and aggregates.
+            else if (auto constant = llvm::dyn_cast<llvm::Constant>(value)) {
+                if (!visitedConstants.insert(constant).second) {
+                    return;
+                }
+
+                for (const auto &operand : constant->operands()) {
+                    collectReferencedGlobals(operand.get(), globals, visitedConstants);
+                }
+            }
+        }
+
+        /**
+         * Describe everything about a global which code referring to it
+         * depends upon, but not its definition.
+         */
+        std::string findSignature(const llvm::GlobalValue &globalValue) {
+            std::string signature;
+            llvm::raw_string_ostream signatureStream = llvm::raw_string_ostream(signature);
+
+            signatureStream << globalValue.getName() << ':';
+            globalValue.getValueType()->print(signatureStream);
+
+            signatureStream << ':' << (int)globalValue.getLinkage()
+                << ':' << (int)globalValue.getVisibility()
+                << ':' << (int)globalValue.getThreadLocalMode();
+
+            if (auto function = llvm::dyn_cast<llvm::Function>(&globalValue)) {
+                signatureStream << ':' << function->getCallingConv()
+                    << ':' << function->getAttributes().getAsString(llvm::AttributeList::FunctionIndex);
+            }
+
+            return signatureStream.str();
+        }
+
+        /**
+         * Lazily declares, within a unit module, every global which the
+         * unit refers to but does not define.
+         */
+        class DeclarationMaterializer : public llvm::ValueMaterializer {
+        private:
+            llvm::Module &unitModule;
+
+        public:
+            explicit DeclarationMaterializer(llvm::Module &unitModule) :
+                unitModule(unitModule) {
+                //
+            }
+
+            llvm::Value *materialize(llvm::Value *value) override {
+                auto globalValue = llvm::dyn_cast<llvm::GlobalValue>(value);
+
+                if (globalValue == nullptr) {
+                    return nullptr;
+                }
+
+                llvm::GlobalValue::LinkageTypes linkage = globalValue->hasExternalWeakLinkage()
+                    ? llvm::GlobalValue::ExternalWeakLinkage
+                    : llvm::GlobalValue::ExternalLinkage;
+
+                llvm::GlobalValue *declaration;
+
+                if (auto function = llvm::dyn_cast<llvm::Function>(globalValue)) {
+                    llvm::Function *functionDeclaration = llvm::Function::Create(
+                        function->getFunctionType(),
+                        linkage,
+                        function->getAddressSpace(),
+                        function->getName(),
+                        &this->unitModule
+                    );
+
+                    functionDeclaration->setCallingConv(function->getCallingConv());
+                    functionDeclaration->setAttributes(function->getAttributes());
+                    declaration = functionDeclaration;
+                }
+                else if (auto globalVariable = llvm::dyn_cast<llvm::GlobalVariable>(globalValue)) {
+                    declaration = new llvm::GlobalVariable(
+                        this->unitModule,
+                        globalVariable->getValueType(),
+                        globalVariable->isConstant(),
+                        linkage,
+                        nullptr,
+                        globalVariable->getName(),
+                        nullptr,
+                        globalVariable->getThreadLocalMode(),
+                        globalVariable->getType()->getAddressSpace()
+                    );
+                }
+                // Aliases and indirect functions never reach splitting.
+                else {
+                    return nullptr;
+                }
+
+                declaration->setVisibility(globalValue->getVisibility());
+                declaration->setDLLStorageClass(globalValue->getDLLStorageClass());
+
+                return declaration;
+            }
+        };
+
+        void copyComdat(const llvm::GlobalObject &source, llvm::GlobalObject &target, llvm::Module &targetModule) {
+            if (const llvm::Comdat *comdat = source.getComdat()) {
+                llvm::Comdat *targetComdat = targetModule.getOrInsertComdat(comdat->getName());
+
+                targetComdat->setSelectionKind(comdat->getSelectionKind());
+                target.setComdat(targetComdat);
+            }
+        }
+    }
+
+    void IncrementalCodegen::promoteLocalSymbols(llvm::Module &module) const {
+        std::vector<llvm::GlobalValue *> localGlobals = {};
+
+        for (auto &globalValue : module.global_values()) {
+            if (globalValue.hasLocalLinkage()) {
+                localGlobals.push_back(&globalValue);
+            }
+        }
+
+        for (const auto globalValue : localGlobals) {
+            std::string name = globalValue->hasName()
+                ? globalValue->getName().str()
+                : "__ilc_anonymous";
+
+            // Suffix the name, since the same local name may appear in other inputs.
+            globalValue->setName(name + ".ilc." + this->opts.moduleTag);
+            globalValue->setLinkage(llvm::GlobalValue::ExternalLinkage);
+            globalValue->setVisibility(llvm::GlobalValue::HiddenVisibility);
+        }
+    }
+
+    std::unique_ptr<llvm::Module> IncrementalCodegen::extractUnit(
+        llvm::Module &module,
+        const std::vector<llvm::GlobalValue *> &definitions
+    ) {
+        std::unique_ptr<llvm::Module> unitModule =
+            std::make_unique<llvm::Module>(module.getModuleIdentifier(), module.getContext());
+
+        unitModule->setSourceFileName(module.getSourceFileName());
+        unitModule->setDataLayout(module.getDataLayout());
+        unitModule->setTargetTriple(module.getTargetTriple());
+
+        // Module flags, such as the PIC level, affect code generation.
+        llvm::SmallVector<llvm::Module::ModuleFlagEntry, 8> moduleFlags = {};
+
+        module.getModuleFlagsMetadata(moduleFlags);
+
+        for (const auto &moduleFlag : moduleFlags) {
+            unitModule->addModuleFlag(moduleFlag.Behavior, moduleFlag.Key->getString(), moduleFlag.Val);
+        }
+
+        llvm::ValueToValueMapTy valueMap = llvm::ValueToValueMapTy();
+        DeclarationMaterializer materializer = DeclarationMaterializer(*unitModule);
+        llvm::ValueMapper valueMapper = llvm::ValueMapper(valueMap, llvm::RF_IgnoreMissingLocals, nullptr, &materializer);
+        std::vector<std::pair<llvm::Function *, llvm::Function *>> functions = {};
+        std::vector<std::pair<llvm::GlobalVariable *, llvm::GlobalVariable *>> globalVariables = {};
+
+        // Definitions are created before anything is mapped, since they may refer to one another.
+        for (const auto definition : definitions) {
+            llvm::GlobalObject *unitDefinition;
+
+            if (auto function = llvm::dyn_cast<llvm::Function>(definition)) {
+                llvm::Function *unitFunction = llvm::Function::Create(
+                    function->getFunctionType(),
+                    function->getLinkage(),
+                    function->getAddressSpace(),
+                    function->getName(),
+                    unitModule.get()
+                );
+
+                unitFunction->copyAttributesFrom(function);
+                functions.emplace_back(function, unitFunction);
+                unitDefinition = unitFunction;
+            }
+            else {
+                auto globalVariable = llvm::cast<llvm::GlobalVariable>(definition);
+
+                auto unitGlobalVariable = new llvm::GlobalVariable(
+                    *unitModule,
+                    globalVariable->getValueType(),
+                    globalVariable->isConstant(),
+                    globalVariable->getLinkage(),
+                    nullptr,
+                    globalVariable->getName(),
+                    nullptr,
+                    globalVariable->getThreadLocalMode(),
+                    globalVariable->getType()->getAddressSpace(),
+                    globalVariable->isExternallyInitialized()
+                );
+
+                unitGlobalVariable->copyAttributesFrom(globalVariable);
+                globalVariables.emplace_back(globalVariable, unitGlobalVariable);
+                unitDefinition = unitGlobalVariable;
+            }
+
+            auto globalObject = llvm::cast<llvm::GlobalObject>(definition);
+
+            copyComdat(*globalObject, *unitDefinition, *unitModule);
+            unitDefinition->copyMetadata(globalObject, 0);
+            valueMap[definition] = unitDefinition;
+        }
+
+        // Bodies are moved rather than copied, so each is only ever processed once.
+        for (const auto &[function, unitFunction] : functions) {
+            auto unitArgument = unitFunction->arg_begin();
+
+            for (auto &argument : function->args()) {
+                unitArgument->takeName(&argument);
+                valueMap[&argument] = &*unitArgument++;
+            }
+
+            unitFunction->getBasicBlockList().splice(unitFunction->end(), function->getBasicBlockList());
+
+            // Remaps the moved instructions, along with the personality and metadata copied above.
+            valueMapper.remapFunction(*unitFunction);
+        }
+
+        for (const auto &[globalVariable, unitGlobalVariable] : globalVariables) {
+            if (globalVariable->hasInitializer()) {
+                unitGlobalVariable->setInitializer(valueMapper.mapConstant(*globalVariable->getInitializer()));
+                globalVariable->setInitializer(nullptr);
+            }
+
+            llvm::SmallVector<std::pair<unsigned, llvm::MDNode *>, 4> attachments = {};
+
+            unitGlobalVariable->getAllMetadata(attachments);
+            unitGlobalVariable->clearMetadata();
+
+            // The same kind may be attached more than once, such as type identifiers.
+            for (const auto &[kind, node] : attachments) {
+                unitGlobalVariable->addMetadata(kind, *valueMapper.mapMDNode(*node));
+            }
+        }
+
+        return unitModule;
+    }
+
+    std::string IncrementalCodegen::findUnitKey(
+        const llvm::Module &module,
+        const std::vector<const llvm::GlobalValue *> &definitions
+    ) const {
+        std::string contents;
+        llvm::raw_string_ostream contentsStream = llvm::raw_string_ostream(contents);
+        std::set<const llvm::GlobalValue *> referencedGlobals = {};
+        std::set<const llvm::Constant *> visitedConstants = {};
+
+        contentsStream << ILC_INCREMENTAL_CODEGEN_SCHEMA_VERSION
+            << '\n' << ILC_CLI_VERSION
+            << '\n' << LLVM_VERSION_STRING
+            << '\n' << this->opts.configurationKey
+            << '\n' << module.getDataLayoutStr()
+            << '\n' << module.getModuleInlineAsm()
+            << '\n';
+
+        for (const auto definition : definitions) {
+            definition->print(contentsStream);
+            contentsStream << '\n';
+
+            if (auto function = llvm::dyn_cast<llvm::Function>(definition)) {
+                for (const auto &instruction : llvm::instructions(function)) {
+                    for (const auto &operand : instruction.operands()) {
+                        collectReferencedGlobals(operand.get(), referencedGlobals, visitedConstants);
+                    }
+                }
+            }
+            else if (auto globalVariable = llvm::dyn_cast<llvm::GlobalVariable>(definition)) {
+                if (globalVariable->hasInitializer()) {
+                    collectReferencedGlobals(globalVariable->getInitializer(), referencedGlobals, visitedConstants);
+                }
+            }
+        }
+
+        // Ordered by name, since pointer order differs between runs.
+        std::set<std::string> signatures = {};
+
+        for (const auto globalValue : referencedGlobals) {
+            signatures.insert(findSignature(*globalValue));
+        }
+
+        for (const auto &signature : signatures) {
+            contentsStream << signature << '\n';
+        }
+
+        llvm::SHA1 hasher = llvm::SHA1();
+
+        hasher.update(contentsStream.str());
+
+        return llvm::toHex(hasher.final(), true);
+    }
+
+    std::filesystem::path IncrementalCodegen::findCacheFilePath(const std::string &key) const {
+        return std::filesystem::path(this->opts.cacheDirectory)
+            .append(ILC_INCREMENTAL_CODEGEN_FILE_PREFIX + key);
+    }
+
+    std::unique_ptr<llvm::MemoryBuffer> IncrementalCodegen::loadCachedObject(const std::string &key) const {
+        llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> object =
+            llvm::MemoryBuffer::getFile(this->findCacheFilePath(key).string(), -1, false);
+
+        if (!object) {
+            return nullptr;
+        }
+
+        return std::move(*object);
+    }
+
+    void IncrementalCodegen::storeCachedObject(const std::string &key, const llvm::MemoryBuffer &object) const {
+        int fileDescriptor;
+        llvm::SmallString<128> temporaryFilePath;
+
+        std::string temporaryFileModel = std::filesystem::path(this->opts.cacheDirectory)
+            .append(ILC_INCREMENTAL_CODEGEN_FILE_PREFIX "tmp-%%%%%%%%")
+            .string();
+
+        // Failing to cache is not an error; the object is simply emitted again next time.
+        if (llvm::sys::fs::createUniqueFile(temporaryFileModel, fileDescriptor, temporaryFilePath)) {
+            return;
+        }
+
+        {
+            llvm::raw_fd_ostream temporaryFileStream = llvm::raw_fd_ostream(fileDescriptor, true);
+
+            temporaryFileStream << object.getBuffer();
+        }
+
+        /**
+         * Renaming is atomic, so concurrent compilations never observe a
+         * partially written object.
+         */
+        if (llvm::sys::fs::rename(temporaryFilePath, this->findCacheFilePath(key).string())) {
+            llvm::sys::fs::remove(temporaryFilePath);
+        }
+    }
+
+    bool IncrementalCodegen::isAvailable() noexcept {
+        return Linker::isAvailable();
+    }
+
+    IncrementalCodegen::IncrementalCodegen(IncrementalCodegenOpts opts) :
+        opts(std::move(opts)) {
+        //
+    }
+
+    std::unique_ptr<llvm::MemoryBuffer> IncrementalCodegen::run(llvm::Module &module, const ModuleEmitter &emit) {
+        std::error_code errorCode = std::error_code();
+
+        std::filesystem::create_directories(this->opts.cacheDirectory, errorCode);
+
+        /**
+         * Aliases and indirect functions must be defined in the same
+         * object as their targets, which splitting cannot guarantee.
+         * Module-level assembly would be emitted once per unit, and
+         * debug information belongs to a single compile unit.
+         */
+        bool isSplittable = module.alias_empty()
+            && module.ifunc_empty()
+            && module.getModuleInlineAsm().empty()
+            && module.debug_compile_units_begin() == module.debug_compile_units_end();
+
+        if (errorCode || !isSplittable) {
+            log::verbose("Module cannot be emitted incrementally; emitting it as a whole");
+
+            return emit(module);
+        }
+
+        this->promoteLocalSymbols(module);
+
+        std::vector<std::vector<const llvm::GlobalValue *>> units = {};
+        std::vector<const llvm::GlobalValue *> dataUnit = {};
+
+        for (const auto &function : module) {
+            if (!function.isDeclaration()) {
+                units.push_back({&function});
+            }
+        }
+
+        for (const auto &globalVariable : module.globals()) {
+            if (!globalVariable.isDeclaration()) {
+                dataUnit.push_back(&globalVariable);
+            }
+        }
+
+        if (!dataUnit.empty()) {
+            units.push_back(dataUnit);
+        }
+
+        // Keys are computed upon the whole module, before any unit is moved out of it.
+        std::vector<std::string> keys = {};
+        std::vector<std::unique_ptr<llvm::MemoryBuffer>> objects = {};
+        std::vector<size_t> missedUnits = {};
+
+        for (size_t i = 0; i < units.size(); i++) {
+            keys.push_back(this->findUnitKey(module, units[i]));
+            objects.push_back(this->loadCachedObject(keys[i]));
+
+            if (objects[i] == nullptr) {
+                missedUnits.push_back(i);
+            }
+        }
+
+        log::verbose(
+            "Reused " + std::to_string(units.size() - missedUnits.size()) + " of "
+                + std::to_string(units.size()) + " code generation unit(s)"
+        );
+
+        /**
+         * Missed units are moved out of a single copy of the module,
+         * rather than each copying the whole module, which would make
+         * a cold build quadratic in the amount of functions. The module
+         * itself is left whole for the reports which inspect it.
+         */
+        if (!missedUnits.empty()) {
+            llvm::ValueToValueMapTy cloneMap = llvm::ValueToValueMapTy();
+            std::unique_ptr<llvm::Module> moduleCopy = llvm::CloneModule(module, cloneMap);
+
+            for (const auto i : missedUnits) {
+                std::vector<llvm::GlobalValue *> definitions = {};
+
+                for (const auto definition : units[i]) {
+                    definitions.push_back(llvm::cast<llvm::GlobalValue>(cloneMap[definition]));
+                }
+
+                std::unique_ptr<llvm::Module> unitModule = IncrementalCodegen::extractUnit(*moduleCopy, definitions);
+
+                objects[i] = emit(*unitModule);
+
+                if (objects[i] == nullptr) {
+                    return nullptr;
+                }
+
+                this->storeCachedObject(keys[i], *objects[i]);
+            }
+        }
+
+        std::filesystem::path combinedFilePath = std::filesystem::path(this->opts.cacheDirectory)
+            .append(this->opts.moduleTag + ".partial.o");
+
+        Linker linker = Linker(LinkerOpts{
+            LinkKind::Relocatable,
+            combinedFilePath,
+            this->opts.targetTriple,
+            false,
+            false,
+            false
+        });
+
+        if (!linker.link(objects)) {
+            return nullptr;
+        }
+
+        // Read the combined object into memory, since its file is removed right after.
+        llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> combinedObject =
+            llvm::MemoryBuffer::getFile(combinedFilePath.string(), -1, false, true);
+
+        std::filesystem::remove(combinedFilePath, errorCode);
+
+        if (!combinedObject) {
+            log::error("Could not read combined object: " + combinedObject.getError().message());
+
+            return nullptr;
+        }
+
+        // Keep the cache from growing unbounded, using LLVM's default policy.
+        llvm::Expected<llvm::CachePruningPolicy> policy = llvm::parseCachePruningPolicy("");
+
+        if (policy) {
+            llvm::pruneCache(this->opts.cacheDirectory.string(), *policy);
+        }
+        else {
+            llvm::consumeError(policy.takeError());
+        }
+
+        return std::move(*combinedObject);
+    }
+}
@@ -0,0 +1,37 @@
+#include <filesystem>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/BinaryFormat/Magic.h>
+#include <ilc/processing/input_classifier.h>
+
+namespace ilc {
+    InputKind InputClassifier::classify(const std::string &inputFilePath, const std::string &input) {
+        std::string extension = std::filesystem::path(inputFilePath).extension().string();
+
+        if (extension == ".ll") {
+            return InputKind::LlvmIr;
+        }
+        else if (extension == ".bc") {
+            return InputKind::LlvmBitcode;
+        }
+        else if (extension == ".mir") {
+            return InputKind::Mir;
+        }
+        // Recognizes both raw and wrapped bitcode.
+        else if (llvm::identify_magic(input) == llvm::file_magic::bitcode) {
+            return InputKind::LlvmBitcode;
+        }
+        // As printed by LLVM; Ion sources cannot begin with either.
+        else if (input.rfind("; ModuleID", 0) == 0) {
+            return InputKind::LlvmIr;
+        }
+        else if (input.rfind("---", 0) == 0) {
+            return InputKind::Mir;
+        }
+
+        return InputKind::Ion;
+    }
+
+    bool InputClassifier::isBackendInput(InputKind kind) noexcept {
+        return kind != InputKind::Ion;
+    }
+}
@@ -0,0 +1,393 @@
+#include <ilc/cli/cross_platform.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/raw_ostream.h>
+#include <ilc/misc/log.h>
+#include <ilc/processing/linker.h>
+
+// OS_LINUX covers every Unix, while memfd_create(2) is specific to Linux.
+#if defined(__linux__)
+    #define ILC_MEMFD_AVAILABLE
+
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+#if defined(ILC_LLD)
+    #include <lld/Common/Driver.h>
+#endif
+
+namespace ilc {
+    namespace {
+        /**
+         * A single object handed over to the linker by path. Depending on
+         * the platform, the path refers either to an anonymous in-memory
+         * file, or to a temporary file which is removed upon destruction.
+         */
+        class LinkerInputFile {
+        private:
+            std::string path;
+
+            int fileDescriptor = -1;
+
+            bool temporary = false;
+
+        public:
+            static std::optional<LinkerInputFile> create(
+                const llvm::MemoryBuffer &object,
+                const std::filesystem::path &temporaryFilePath
+            ) {
+                LinkerInputFile result = LinkerInputFile();
+
+#if defined(ILC_MEMFD_AVAILABLE)
+                int fileDescriptor = memfd_create("ilc-object", 0);
+
+                if (fileDescriptor != -1) {
+                    const char *data = object.getBufferStart();
+                    size_t remaining = object.getBufferSize();
+
+                    while (remaining > 0) {
+                        ssize_t written = write(fileDescriptor, data, remaining);
+
+                        if (written <= 0) {
+                            close(fileDescriptor);
+
+                            return std::nullopt;
+                        }
+
+                        data += written;
+                        remaining -= written;
+                    }
+
+                    result.fileDescriptor = fileDescriptor;
+                    result.path = "/proc/self/fd/" + std::to_string(fileDescriptor);
+
+                    return result;
+                }
+#endif
+
+                // Fallback to a temporary file on disk.
+                std::ofstream stream = std::ofstream(temporaryFilePath, std::ios::binary | std::ios::trunc);
+
+                stream.write(object.getBufferStart(), object.getBufferSize());
+
+                if (!stream.good()) {
+                    return std::nullopt;
+                }
+
+                result.path = temporaryFilePath.string();
+                result.temporary = true;
+
+                return result;
+            }
+
+            LinkerInputFile() = default;
+
+            LinkerInputFile(LinkerInputFile &&other) noexcept :
+                path(std::move(other.path)),
+                fileDescriptor(other.fileDescriptor),
+                temporary(other.temporary) {
+                other.fileDescriptor = -1;
+                other.temporary = false;
+            }
+
+            LinkerInputFile(const LinkerInputFile &) = delete;
+
+            ~LinkerInputFile() {
+#if defined(ILC_MEMFD_AVAILABLE)
+                if (this->fileDescriptor != -1) {
+                    close(this->fileDescriptor);
+                }
+#endif
+
+                if (this->temporary) {
+                    std::error_code errorCode = std::error_code();
+
+                    std::filesystem::remove(this->path, errorCode);
+                }
+            }
+
+            [[nodiscard]] const std::string &getPath() const noexcept {
+                return this->path;
+            }
+        };
+    }
+
+    std::optional<std::string> Linker::findRuntimeFile(const std::string &fileName) const {
+        for (const auto &libraryDirectory : this->findLibraryDirectories()) {
+            std::filesystem::path candidate = std::filesystem::path(libraryDirectory).append(fileName);
+
+            if (std::filesystem::exists(candidate)) {
+                return candidate.string();
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::vector<std::string> Linker::findLibraryDirectories() const {
+        // Debian-style multi-architecture directories take precedence.
+        std::string multiArchName = this->opts.targetTriple.getArchName().str() + "-linux-gnu";
+
+        return {
+            "/usr/lib/" + multiArchName,
+            "/lib/" + multiArchName,
+            "/usr/lib64",
+            "/lib64",
+            "/usr/lib",
+            "/lib"
+        };
+    }
+
+    std::optional<std::string> Linker::findDynamicLinker() const {
+        switch (this->opts.targetTriple.getArch()) {
+            case llvm::Triple::x86_64: {
+                return "/lib64/ld-linux-x86-64.so.2";
+            }
+
+            case llvm::Triple::x86: {
+                return "/lib/ld-linux.so.2";
+            }
+
+            case llvm::Triple::aarch64: {
+                return "/lib/ld-linux-aarch64.so.1";
+            }
+
+            case llvm::Triple::riscv64: {
+                return "/lib/ld-linux-riscv64-lp64d.so.1";
+            }
+
+            default: {
+                return std::nullopt;
+            }
+        }
+    }
+
+    std::optional<std::string> Linker::findProfileRuntime() const {
+        if (this->opts.profileRuntimePath.has_value()) {
+            return this->opts.profileRuntimePath;
+        }
+
+        std::string archName = this->opts.targetTriple.getArchName().str();
+        std::vector<std::filesystem::path> resourceParentDirectories = {"/usr/local/lib/clang", "/usr/lib/clang"};
+        std::error_code errorCode = std::error_code();
+
+        // Debian-style installations keep one resource directory per LLVM version.
+        for (const auto &entry : std::filesystem::directory_iterator("/usr/lib", errorCode)) {
+            if (entry.path().filename().string().rfind("llvm-", 0) == 0) {
+                resourceParentDirectories.push_back(std::filesystem::path(entry.path()).append("lib").append("clang"));
+            }
+        }
+
+        std::optional<std::string> result = std::nullopt;
+        long resultVersion = -1;
+
+        /**
+         * The runtime's raw profile format must match the one LLVM reads
+         * back, which changes between major versions.
+         */
+        auto isPreferred = [&](long version) {
+            if (resultVersion == LLVM_VERSION_MAJOR) {
+                return false;
+            }
+
+            return version == LLVM_VERSION_MAJOR || version > resultVersion;
+        };
+
+        for (const auto &resourceParentDirectory : resourceParentDirectories) {
+            for (const auto &entry : std::filesystem::directory_iterator(resourceParentDirectory, errorCode)) {
+                // Resource directories are named after either the full or the major version.
+                long version = std::strtol(entry.path().filename().c_str(), nullptr, 10);
+
+                std::vector<std::filesystem::path> candidates = {
+                    std::filesystem::path(entry.path()).append("lib").append("linux")
+                        .append("libclang_rt.profile-" + archName + ".a"),
+
+                    // Newer releases name runtime directories after the target triple.
+                    std::filesystem::path(entry.path()).append("lib").append(this->opts.targetTriple.str())
+                        .append("libclang_rt.profile.a")
+                };
+
+                for (const auto &candidate : candidates) {
+                    if (isPreferred(version) && std::filesystem::exists(candidate, errorCode)) {
+                        result = candidate.string();
+                        resultVersion = version;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    bool Linker::isAvailable() noexcept {
+#if defined(ILC_LLD)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    Linker::Linker(LinkerOpts opts) :
+        opts(std::move(opts)) {
+        //
+    }
+
+    bool Linker::link(const std::vector<std::unique_ptr<llvm::MemoryBuffer>> &objects) {
+        if (!Linker::isAvailable()) {
+            log::error("In-process linking is unavailable; ilc was built without LLD");
+
+            return false;
+        }
+        else if (!this->opts.targetTriple.isOSBinFormatELF()) {
+            log::error("In-process linking only supports ELF targets");
+
+            return false;
+        }
+
+        bool isExecutable = this->opts.kind == LinkKind::Executable;
+        bool isRelocatable = this->opts.kind == LinkKind::Relocatable;
+        std::vector<LinkerInputFile> inputFiles = {};
+
+        for (size_t i = 0; i < objects.size(); i++) {
+            std::filesystem::path temporaryFilePath = std::filesystem::path(this->opts.outputFilePath)
+                .concat(".tmp." + std::to_string(i) + ".o");
+
+            std::optional<LinkerInputFile> inputFile =
+                LinkerInputFile::create(*objects[i], temporaryFilePath);
+
+            if (!inputFile.has_value()) {
+                log::error("Could not prepare object for linking");
+
+                return false;
+            }
+
+            inputFiles.push_back(std::move(*inputFile));
+        }
+
+        // Owns the strings referred to by the argument vector.
+        std::vector<std::string> arguments = {"ld.lld", "-o", this->opts.outputFilePath.string()};
+
+        if (this->opts.kind == LinkKind::SharedObject) {
+            arguments.emplace_back("-shared");
+        }
+        else if (isRelocatable) {
+            arguments.emplace_back("-r");
+        }
+
+        if (isExecutable) {
+            std::optional<std::string> dynamicLinker = this->findDynamicLinker();
+
+            if (dynamicLinker.has_value()) {
+                arguments.emplace_back("-dynamic-linker");
+                arguments.push_back(*dynamicLinker);
+            }
+        }
+
+        // Only final links produce these; they would be rejected otherwise.
+        if (!isRelocatable) {
+            arguments.emplace_back("--eh-frame-hdr");
+        }
+
+        if (this->opts.gcSections && !isRelocatable) {
+            arguments.emplace_back("--gc-sections");
+        }
+
+        if (this->opts.icf && !isRelocatable) {
+            arguments.emplace_back("--icf=all");
+        }
+
+        // Allow LLD to parallelize the link itself.
+        arguments.emplace_back("--threads");
+
+        std::vector<std::string> trailingArguments = {};
+
+        if (this->opts.defaultLibraries && !isRelocatable) {
+            for (const auto &libraryDirectory : this->findLibraryDirectories()) {
+                if (std::filesystem::exists(libraryDirectory)) {
+                    arguments.push_back("-L" + libraryDirectory);
+                }
+            }
+
+            std::vector<std::string> startFileNames = {"crti.o"};
+
+            if (isExecutable) {
+                startFileNames.insert(startFileNames.begin(), "crt1.o");
+            }
+
+            for (const auto &startFileName : startFileNames) {
+                std::optional<std::string> startFile = this->findRuntimeFile(startFileName);
+
+                if (startFile.has_value()) {
+                    arguments.push_back(*startFile);
+                }
+            }
+
+            std::optional<std::string> endFile = this->findRuntimeFile("crtn.o");
+
+            trailingArguments.emplace_back("-lc");
+
+            if (endFile.has_value()) {
+                trailingArguments.push_back(*endFile);
+            }
+        }
+
+        if (this->opts.profileRuntime && !isRelocatable) {
+            std::optional<std::string> profileRuntime = this->findProfileRuntime();
+
+            /**
+             * Instrumented objects do not refer to the runtime themselves
+             * on Linux; it is pulled in by the linker instead, so that
+             * its registration code runs.
+             */
+            arguments.emplace_back("-u__llvm_profile_runtime");
+
+            if (profileRuntime.has_value()) {
+                trailingArguments.insert(trailingArguments.begin(), *profileRuntime);
+            }
+            else {
+                log::warning("Could not find LLVM's profile runtime (libclang_rt.profile); pass its path through --profile-runtime");
+            }
+        }
+
+        for (const auto &inputFile : inputFiles) {
+            arguments.push_back(inputFile.getPath());
+        }
+
+        arguments.insert(arguments.end(), trailingArguments.begin(), trailingArguments.end());
+        arguments.insert(arguments.end(), this->opts.extraArguments.begin(), this->opts.extraArguments.end());
+
+        std::vector<const char *> argumentPointers = {};
+
+        for (const auto &argument : arguments) {
+            argumentPointers.push_back(argument.c_str());
+        }
+
+#if defined(ILC_LLD)
+        // LLD keeps global state, and must not be invoked concurrently.
+        static std::mutex linkMutex;
+        std::lock_guard<std::mutex> lock(linkMutex);
+
+        std::string diagnostics;
+        llvm::raw_string_ostream diagnosticsStream = llvm::raw_string_ostream(diagnostics);
+        bool success = lld::elf::link(argumentPointers, false, diagnosticsStream);
+
+        diagnosticsStream.flush();
+
+        if (!diagnostics.empty() && success) {
+            log::warning("Linker: " + diagnostics);
+        }
+        else if (!diagnostics.empty()) {
+            log::error("Linker: " + diagnostics);
+        }
+
+        return success;
+#else
+        return false;
+#endif
+    }
+}
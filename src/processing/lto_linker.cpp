@@ -0,0 +1,166 @@
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/DiagnosticInfo.h>
+#include <llvm/IR/DiagnosticPrinter.h>
+#include <llvm/LTO/Caching.h>
+#include <llvm/LTO/LTO.h>
+#include <llvm/Support/CachePruning.h>
+#include <llvm/Support/SmallVectorMemoryBuffer.h>
+#include <ilc/misc/log.h>
+#include <ilc/misc/thread_pool.h>
+#include <ilc/processing/remarks.h>
+#include <ilc/processing/lto_linker.h>
+
+#define ILC_LTO_ENTRY_POINT_NAME "main"
+
+namespace ilc {
+    LtoLinker::LtoLinker(LtoLinkerOpts opts) :
+        opts(std::move(opts)) {
+        //
+    }
+
+    void LtoLinker::addInput(std::unique_ptr<llvm::MemoryBuffer> input) {
+        this->inputs.push_back(std::move(input));
+    }
+
+    std::optional<std::vector<std::unique_ptr<llvm::MemoryBuffer>>> LtoLinker::link() {
+        llvm::lto::Config config = llvm::lto::Config();
+
+        config.CPU = this->opts.cpuName;
+        config.MAttrs = this->opts.cpuFeatures;
+        config.OptLevel = this->opts.optimizationLevel;
+        config.CGOptLevel = this->opts.codeGenOptimizationLevel;
+        config.DefaultTriple = this->opts.targetTriple.getTriple();
+
+        if (this->opts.remarksFilePath.has_value()) {
+            config.RemarksFilename = this->opts.remarksFilePath->string();
+            config.RemarksPasses = this->opts.remarksFilter.value_or("");
+
+#if LLVM_VERSION_MAJOR >= 10
+            config.RemarksFormat = Remarks::findFormat(*this->opts.remarksFilePath);
+#endif
+        }
+
+        config.DiagHandler = [](const llvm::DiagnosticInfo &diagnosticInfo) {
+            std::string message;
+            llvm::raw_string_ostream messageStream = llvm::raw_string_ostream(message);
+            llvm::DiagnosticPrinterRawOStream diagnosticPrinter = llvm::DiagnosticPrinterRawOStream(messageStream);
+
+            diagnosticInfo.print(diagnosticPrinter);
+            messageStream.flush();
+
+            if (diagnosticInfo.getSeverity() == llvm::DS_Error) {
+                log::error("LTO: " + message);
+            }
+            else {
+                log::warning("LTO: " + message);
+            }
+        };
+
+        llvm::lto::ThinBackend thinBackend = llvm::lto::createInProcessThinBackend(
+            ThreadPool::resolveThreadCount(this->opts.jobs)
+        );
+
+        llvm::lto::LTO lto = llvm::lto::LTO(std::move(config), thinBackend);
+        std::set<std::string> definedSymbols = {};
+
+        for (const auto &input : this->inputs) {
+            llvm::Expected<std::unique_ptr<llvm::lto::InputFile>> inputFile =
+                llvm::lto::InputFile::create(input->getMemBufferRef());
+
+            if (!inputFile) {
+                log::error("Could not load LTO input: " + llvm::toString(inputFile.takeError()));
+
+                return std::nullopt;
+            }
+
+            std::vector<llvm::lto::SymbolResolution> resolutions = {};
+
+            for (const auto &symbol : (*inputFile)->symbols()) {
+                llvm::lto::SymbolResolution resolution = llvm::lto::SymbolResolution();
+                std::string name = symbol.getName();
+
+                // The first definition of a symbol prevails over any later one.
+                resolution.Prevailing = !symbol.isUndefined() && definedSymbols.insert(name).second;
+
+                /**
+                 * Symbols visible to regular objects are preserved as-is;
+                 * all others may be internalized, and then removed if unused.
+                 */
+                resolution.VisibleToRegularObj = !this->opts.internalize
+                    || name == ILC_LTO_ENTRY_POINT_NAME;
+
+                resolutions.push_back(resolution);
+            }
+
+            if (llvm::Error error = lto.add(std::move(*inputFile), resolutions)) {
+                log::error("Could not add LTO input: " + llvm::toString(std::move(error)));
+
+                return std::nullopt;
+            }
+        }
+
+        const size_t maxTasks = lto.getMaxTasks();
+        std::vector<llvm::SmallVector<char, 0>> objectBuffers = std::vector<llvm::SmallVector<char, 0>>(maxTasks);
+        std::vector<std::unique_ptr<llvm::MemoryBuffer>> cachedObjects = std::vector<std::unique_ptr<llvm::MemoryBuffer>>(maxTasks);
+        llvm::lto::NativeObjectCache cache = nullptr;
+
+        auto addStream = [&](size_t task) -> std::unique_ptr<llvm::lto::NativeObjectStream> {
+            return std::make_unique<llvm::lto::NativeObjectStream>(
+                std::make_unique<llvm::raw_svector_ostream>(objectBuffers[task])
+            );
+        };
+
+        // Only the ThinLTO backends are able to make use of the cache.
+        if (this->opts.kind == cli::LtoKind::Thin && this->opts.cacheDirectory.has_value()) {
+            llvm::Expected<llvm::lto::NativeObjectCache> localCache = llvm::lto::localCache(
+                this->opts.cacheDirectory->string(),
+
+                [&](size_t task, std::unique_ptr<llvm::MemoryBuffer> buffer) {
+                    cachedObjects[task] = std::move(buffer);
+                }
+            );
+
+            if (!localCache) {
+                log::error("Could not open ThinLTO cache: " + llvm::toString(localCache.takeError()));
+
+                return std::nullopt;
+            }
+
+            cache = *localCache;
+        }
+
+        if (llvm::Error error = lto.run(addStream, cache)) {
+            log::error("Link-time optimization failed: " + llvm::toString(std::move(error)));
+
+            return std::nullopt;
+        }
+
+        if (cache != nullptr) {
+            // Keep the cache from growing unbounded, using LLVM's default policy.
+            llvm::Expected<llvm::CachePruningPolicy> policy = llvm::parseCachePruningPolicy("");
+
+            if (policy) {
+                llvm::pruneCache(this->opts.cacheDirectory->string(), *policy);
+            }
+            else {
+                llvm::consumeError(policy.takeError());
+            }
+        }
+
+        std::vector<std::unique_ptr<llvm::MemoryBuffer>> result = {};
+
+        for (size_t task = 0; task < maxTasks; task++) {
+            if (cachedObjects[task] != nullptr) {
+                result.push_back(std::move(cachedObjects[task]));
+            }
+            // Tasks for modules without any code produce no output.
+            else if (!objectBuffers[task].empty()) {
+                result.push_back(std::make_unique<llvm::SmallVectorMemoryBuffer>(
+                    std::move(objectBuffers[task])
+                ));
+            }
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,293 @@
+#include <cctype>
+#include <fstream>
+#include <ilc/misc/file_system.h>
+#include <ilc/processing/dependency_scanner.h>
+#include <ilc/processing/module_interface.h>
+
+#define ILC_MODULE_INTERFACE_EXTENSION ".ioni"
+
+/**
+ * Written as the first line of every interface file, but not part of
+ * the interface itself. Bump the version whenever the extracted form
+ * changes.
+ */
+#define ILC_MODULE_INTERFACE_HEADER "// ilc module interface v1\n"
+
+namespace ilc {
+    namespace {
+        bool isIdentifierPart(char character) {
+            return std::isalnum(static_cast<unsigned char>(character)) || character == '_';
+        }
+
+        /**
+         * Removes comments and collapses whitespace, leaving only the
+         * text which is meaningful to the parser.
+         */
+        std::string normalize(const std::string &input) {
+            std::string result;
+            const size_t length = input.length();
+            size_t position = 0;
+            bool pendingSpace = false;
+
+            result.reserve(length);
+
+            while (position < length) {
+                const char character = input[position];
+
+                if (std::isspace(static_cast<unsigned char>(character))) {
+                    pendingSpace = true;
+                    position++;
+
+                    continue;
+                }
+                else if (input.compare(position, 2, "//") == 0) {
+                    position = std::min(input.find('\n', position), length);
+                    pendingSpace = true;
+
+                    continue;
+                }
+                else if (input.compare(position, 2, "/*") == 0) {
+                    size_t end = input.find("*/", position + 2);
+
+                    position = end == std::string::npos ? length : end + 2;
+                    pendingSpace = true;
+
+                    continue;
+                }
+
+                // Spaces are only significant between adjacent identifier characters.
+                if (pendingSpace && !result.empty() && isIdentifierPart(result.back()) && isIdentifierPart(character)) {
+                    result += ' ';
+                }
+
+                pendingSpace = false;
+
+                if (character == '"') {
+                    size_t start = position++;
+
+                    while (position < length && input[position] != '"') {
+                        // Skip over escaped characters.
+                        if (input[position] == '\\') {
+                            position++;
+                        }
+
+                        position++;
+                    }
+
+                    position = std::min(position + 1, length);
+                    result.append(input, start, position - start);
+
+                    continue;
+                }
+
+                result += character;
+                position++;
+            }
+
+            return result;
+        }
+
+        /**
+         * Find the position right after the brace closing the one at the
+         * given position, skipping over string literals.
+         */
+        size_t findClosingBrace(const std::string &text, size_t openingBracePosition) {
+            size_t depth = 0;
+
+            for (size_t position = openingBracePosition; position < text.length(); position++) {
+                if (text[position] == '"') {
+                    while (++position < text.length() && text[position] != '"') {
+                        if (text[position] == '\\') {
+                            position++;
+                        }
+                    }
+                }
+                else if (text[position] == '{') {
+                    depth++;
+                }
+                else if (text[position] == '}' && --depth == 0) {
+                    return position + 1;
+                }
+            }
+
+            return text.length();
+        }
+
+        /**
+         * Find the position right after the given character, or the end
+         * of the text if it does not occur.
+         */
+        size_t findAfter(const std::string &text, size_t position, char character) {
+            size_t found = text.find(character, position);
+
+            return found == std::string::npos ? text.length() : found + 1;
+        }
+
+        /**
+         * Read the keyword or identifier at the given position, if any.
+         */
+        std::string readWord(const std::string &text, size_t position) {
+            size_t end = position;
+
+            while (end < text.length() && isIdentifierPart(text[end])) {
+                end++;
+            }
+
+            return text.substr(position, end - position);
+        }
+    }
+
+    std::filesystem::path ModuleInterface::makePath(const std::filesystem::path &outputFilePath) {
+        return std::filesystem::path(outputFilePath).concat(ILC_MODULE_INTERFACE_EXTENSION);
+    }
+
+    std::string ModuleInterface::extract(const std::string &input) {
+        const std::string text = normalize(input);
+        std::string result;
+
+        // Amount of module blocks currently open.
+        size_t moduleDepth = 0;
+        size_t position = 0;
+
+        while (position < text.length()) {
+            const char character = text[position];
+
+            if (character == ' ' || character == ';') {
+                position++;
+
+                continue;
+            }
+            else if (character == '}') {
+                if (moduleDepth > 0) {
+                    result += "}\n";
+                    moduleDepth--;
+                }
+
+                position++;
+
+                continue;
+            }
+
+            std::string word = readWord(text, position);
+
+            if (word.empty()) {
+                position++;
+
+                continue;
+            }
+
+            size_t statementEnd = findAfter(text, position, ';');
+            size_t blockStart = text.find('{', position);
+
+            // 'module name {' opens a block, while 'module name;' applies to the rest of the file.
+            if (word == "module") {
+                size_t end = std::min(statementEnd, blockStart == std::string::npos ? text.length() : blockStart + 1);
+
+                if (end == blockStart + 1) {
+                    moduleDepth++;
+                }
+
+                result += text.substr(position, end - position) + "\n";
+                position = end;
+            }
+            // Function bodies are dropped, leaving their prototype as an extern.
+            else if (word == "fn" && blockStart != std::string::npos && blockStart < statementEnd) {
+                size_t prototypeStart = position + word.length();
+
+                while (prototypeStart < blockStart && text[prototypeStart] == ' ') {
+                    prototypeStart++;
+                }
+
+                result += "extern " + text.substr(prototypeStart, blockStart - prototypeStart) + ";\n";
+                position = findClosingBrace(text, blockStart);
+            }
+            // Type declarations are kept whole, since dependents may access their fields.
+            else if ((word == "struct" || word == "type") && blockStart != std::string::npos && blockStart < statementEnd) {
+                size_t end = findClosingBrace(text, blockStart);
+
+                result += text.substr(position, end - position) + "\n";
+                position = end;
+            }
+            else if (word == "import" || word == "extern" || word == "global" || word == "struct" || word == "type") {
+                result += text.substr(position, statementEnd - position) + "\n";
+                position = statementEnd;
+            }
+            // Anything else is an implementation detail; skip the whole statement or block.
+            else {
+                position = blockStart != std::string::npos && blockStart < statementEnd
+                    ? findClosingBrace(text, blockStart)
+                    : statementEnd;
+            }
+        }
+
+        return result;
+    }
+
+    bool ModuleInterface::write(const std::filesystem::path &interfaceFilePath, const std::string &interface) {
+        std::optional<std::string> existingInterface = ModuleInterface::read(interfaceFilePath);
+
+        // Preserve the modification time, so that build systems need not rebuild dependents.
+        if (existingInterface.has_value() && *existingInterface == interface) {
+            return true;
+        }
+
+        std::ofstream stream = std::ofstream(interfaceFilePath, std::ios::binary | std::ios::trunc);
+
+        stream << ILC_MODULE_INTERFACE_HEADER << interface;
+
+        return stream.good();
+    }
+
+    std::optional<std::string> ModuleInterface::read(const std::filesystem::path &interfaceFilePath) {
+        if (!std::filesystem::exists(interfaceFilePath)) {
+            return std::nullopt;
+        }
+
+        std::optional<std::string> contents = FileSystem::readFileContents(interfaceFilePath.string());
+
+        // Interfaces written by other versions are ignored.
+        if (!contents.has_value() || contents->rfind(ILC_MODULE_INTERFACE_HEADER, 0) != 0) {
+            return std::nullopt;
+        }
+
+        return contents->substr(std::string(ILC_MODULE_INTERFACE_HEADER).length());
+    }
+
+    std::map<std::string, std::filesystem::path> ModuleInterface::findInterfaceFiles(
+        const std::vector<std::filesystem::path> &searchPaths
+    ) {
+        std::map<std::string, std::filesystem::path> result = {};
+
+        for (const auto &searchPath : searchPaths) {
+            std::error_code errorCode = std::error_code();
+
+            auto iterator = std::filesystem::recursive_directory_iterator(
+                searchPath,
+                std::filesystem::directory_options::skip_permission_denied,
+                errorCode
+            );
+
+            // Missing or unreadable directories simply hold no interfaces.
+            for (; !errorCode && iterator != std::filesystem::end(iterator); iterator.increment(errorCode)) {
+                const std::filesystem::directory_entry &entry = *iterator;
+                std::error_code entryErrorCode = std::error_code();
+
+                if (!entry.is_regular_file(entryErrorCode) || entry.path().extension() != ILC_MODULE_INTERFACE_EXTENSION) {
+                    continue;
+                }
+
+                std::optional<std::string> interface = ModuleInterface::read(entry.path());
+
+                if (!interface.has_value()) {
+                    continue;
+                }
+
+                for (const auto &moduleName : DependencyScanner::scan(*interface).declaredModules) {
+                    result.insert({moduleName, entry.path()});
+                }
+            }
+        }
+
+        return result;
+    }
+}
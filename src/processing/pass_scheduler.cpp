@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <optional>
+#include <ionir/construct/function.h>
+#include <ionir/construct/module.h>
+#include <ilc/misc/function_time_report.h>
+#include <ilc/misc/statistics.h>
+#include <ilc/misc/thread_pool.h>
+#include <ilc/processing/pass_scheduler.h>
+
+#define ILC_PASS_SCHEDULER_SHARDS_PER_JOB 4
+
+namespace ilc {
+    namespace {
+        struct WorkItem {
+            size_t passIndex;
+
+            ionir::Ast ast;
+
+            /**
+             * Whether to only visit the modules of the AST, without their
+             * children.
+             */
+            bool isModuleVisit;
+        };
+    }
+
+    bool PassScheduler::conflicts(const ScheduledPass &first, const ScheduledPass &second) {
+        auto writesAny = [](const ScheduledPass &writer, const std::set<PassResource> &resources) {
+            return std::any_of(writer.writes.begin(), writer.writes.end(), [&](PassResource resource) {
+                return resources.contains(resource);
+            });
+        };
+
+        return writesAny(first, second.reads)
+            || writesAny(first, second.writes)
+            || writesAny(second, first.reads);
+    }
+
+    PassScheduler::PassScheduler(uint32_t jobs) :
+        jobs(ThreadPool::resolveThreadCount(jobs)) {
+        //
+    }
+
+    void PassScheduler::registerPass(ScheduledPass pass) {
+        this->passes.push_back(std::move(pass));
+    }
+
+    std::vector<std::vector<size_t>> PassScheduler::findStages() const {
+        std::vector<std::vector<size_t>> stages = {};
+
+        for (size_t index = 0; index < this->passes.size(); index++) {
+            bool joinsStage = !stages.empty() && std::none_of(
+                stages.back().begin(),
+                stages.back().end(),
+
+                [&](size_t stageIndex) {
+                    return PassScheduler::conflicts(this->passes[stageIndex], this->passes[index]);
+                }
+            );
+
+            if (joinsStage) {
+                stages.back().push_back(index);
+            }
+            else {
+                stages.push_back({index});
+            }
+        }
+
+        return stages;
+    }
+
+    std::vector<ionir::Ast> PassScheduler::findShards(const ionir::Ast &ast, uint32_t jobs) {
+        ionir::Ast units = {};
+
+        for (const auto &construct : ast) {
+            if (construct->constructKind == ionir::ConstructKind::Module) {
+                ionir::Ast children = construct->getChildrenNodes();
+
+                units.insert(units.end(), children.begin(), children.end());
+            }
+            else {
+                units.push_back(construct);
+            }
+        }
+
+        /**
+         * Use several shards per job, so that threads finishing early may
+         * pick up the remaining work of uneven functions. Timing functions
+         * requires a shard of their own for each.
+         */
+        size_t shardCount = FunctionTimeReport::isEnabled()
+            ? units.size()
+            : std::min<size_t>(units.size(), static_cast<size_t>(jobs) * ILC_PASS_SCHEDULER_SHARDS_PER_JOB);
+
+        std::vector<ionir::Ast> shards = {};
+
+        for (size_t shard = 0; shard < shardCount; shard++) {
+            size_t begin = units.size() * shard / shardCount;
+            size_t end = units.size() * (shard + 1) / shardCount;
+
+            shards.emplace_back(units.begin() + begin, units.begin() + end);
+        }
+
+        return shards;
+    }
+
+    void PassScheduler::run(const ionir::Ast &ast, ionshared::Ptr<DiagnosticVector> diagnostics) {
+        uint32_t jobs = this->jobs;
+
+        // Running as a task of a pool, such as a build task, which limits its threads.
+        if (ThreadPool::findNestedThreadCount() != 0) {
+            jobs = std::min(jobs, ThreadPool::findNestedThreadCount());
+        }
+
+        // Computed once, and shared by all function-granular passes.
+        std::optional<std::vector<ionir::Ast>> shards = std::nullopt;
+        ionir::Ast modules = {};
+
+        for (const auto &construct : ast) {
+            if (construct->constructKind == ionir::ConstructKind::Module) {
+                modules.push_back(construct);
+            }
+        }
+
+        for (const auto &stage : this->findStages()) {
+            /**
+             * Work items ordered by registration and then by source
+             * order.
+             */
+            std::vector<WorkItem> workItems = {};
+
+            for (const auto passIndex : stage) {
+                bool isSharded = this->passes[passIndex].functionGranular
+                    && (jobs > 1 || FunctionTimeReport::isEnabled());
+
+                if (!isSharded) {
+                    workItems.push_back(WorkItem{passIndex, ast, false});
+
+                    continue;
+                }
+                else if (!shards.has_value()) {
+                    shards = PassScheduler::findShards(ast, jobs);
+                }
+
+                // Shards only consist of the modules' children.
+                if (!modules.empty()) {
+                    workItems.push_back(WorkItem{passIndex, modules, true});
+                }
+
+                for (const auto &shard : *shards) {
+                    workItems.push_back(WorkItem{passIndex, shard, false});
+                }
+            }
+
+            std::vector<ionshared::Ptr<DiagnosticVector>> workItemDiagnostics = {};
+
+            for (size_t i = 0; i < workItems.size(); i++) {
+                workItemDiagnostics.push_back(std::make_shared<DiagnosticVector>());
+            }
+
+            auto runWorkItem = [&](size_t workItemIndex) {
+                const auto &[passIndex, workItemAst, isModuleVisit] = workItems[workItemIndex];
+
+                ionshared::Ptr<ionshared::PassContext> passContext =
+                    std::make_shared<ionshared::PassContext>(workItemDiagnostics[workItemIndex]);
+
+                ionshared::Ptr<ionir::Pass> pass = this->passes[passIndex].factory(passContext);
+
+                // Visit the modules only, leaving their children to the shards.
+                if (isModuleVisit) {
+                    for (const auto &module : workItemAst) {
+                        pass->visitModule(std::static_pointer_cast<ionir::Module>(module));
+                    }
+
+                    return;
+                }
+
+                ionir::PassManager passManager = ionir::PassManager();
+                std::optional<FunctionTimer> functionTimer = std::nullopt;
+
+                passManager.registerPass(pass);
+
+                // Shards consist of a single function when timing functions.
+                if (workItemAst.size() == 1 && FunctionTimeReport::isEnabled()) {
+                    ionshared::Ptr<ionir::Function> function =
+                        std::dynamic_pointer_cast<ionir::Function>(workItemAst.front());
+
+                    if (function != nullptr) {
+                        functionTimer.emplace(function->prototype->name, this->passes[passIndex].name);
+                    }
+                }
+
+                passManager.run(workItemAst);
+                functionTimer.reset();
+
+                // Counted on the worker thread, without any synchronization.
+                if (Statistics::isEnabled()) {
+                    Statistics::add("passes", this->passes[passIndex].name + ".runs");
+                    Statistics::add("passes", this->passes[passIndex].name + ".constructs", workItemAst.size());
+                }
+            };
+
+            // Avoid the overhead of spawning threads when there is nothing to overlap.
+            if (workItems.size() == 1 || jobs == 1) {
+                for (size_t workItemIndex = 0; workItemIndex < workItems.size(); workItemIndex++) {
+                    runWorkItem(workItemIndex);
+                }
+            }
+            else {
+                ThreadPool threadPool = ThreadPool(std::min<size_t>(jobs, workItems.size()));
+
+                for (size_t workItemIndex = 0; workItemIndex < workItems.size(); workItemIndex++) {
+                    threadPool.submit([&, workItemIndex] {
+                        runWorkItem(workItemIndex);
+                    });
+                }
+
+                threadPool.wait();
+            }
+
+            // Merge in registration and source order, regardless of completion order.
+            for (const auto &itemDiagnostics : workItemDiagnostics) {
+                for (const auto &diagnostic : itemDiagnostics->unwrap()) {
+                    diagnostics->push(diagnostic);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/RemarkStreamer.h>
+#include <ilc/misc/log.h>
+#include <ilc/processing/remarks.h>
+
+namespace ilc {
+    std::filesystem::path Remarks::makePath(
+        const std::filesystem::path &remarksOutputPath,
+        const std::string &unitName
+    ) {
+        std::string sanitizedUnitName = unitName;
+
+        // Input file paths may contain directories, which are flattened.
+        for (auto &character : sanitizedUnitName) {
+            if (character == '/' || character == '\\') {
+                character = '_';
+            }
+        }
+
+        return std::filesystem::path(remarksOutputPath)
+            .replace_filename(remarksOutputPath.stem().string() + "." + sanitizedUnitName)
+            .concat(remarksOutputPath.extension().string());
+    }
+
+    std::string Remarks::findFormat(const std::filesystem::path &remarksFilePath) {
+        return remarksFilePath.extension() == ".bitstream" ? "bitstream" : "yaml";
+    }
+
+    std::unique_ptr<llvm::ToolOutputFile> Remarks::begin(llvm::LLVMContext &context, const RemarksOpts &opts) {
+        std::string format = Remarks::findFormat(opts.remarksFilePath);
+
+#if LLVM_VERSION_MAJOR < 10
+        if (format == "bitstream") {
+            log::error("Bitstream remarks require LLVM 10 or later; use a '.yaml' remarks output instead");
+
+            return nullptr;
+        }
+#endif
+
+        llvm::Expected<std::unique_ptr<llvm::ToolOutputFile>> remarksFile = llvm::setupOptimizationRemarks(
+            context,
+            opts.remarksFilePath.string(),
+            opts.filter.value_or(""),
+            format,
+            false
+        );
+
+        if (!remarksFile) {
+            log::error("Could not open remarks file: " + llvm::toString(remarksFile.takeError()));
+
+            return nullptr;
+        }
+
+        return std::move(*remarksFile);
+    }
+
+    void Remarks::finish(llvm::LLVMContext &context, std::unique_ptr<llvm::ToolOutputFile> remarksFile) {
+        // The streamer refers to the file's stream, so it must go first.
+        context.setRemarkStreamer(nullptr);
+
+        if (remarksFile != nullptr) {
+            remarksFile->keep();
+        }
+    }
+}
@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <ilc/misc/file_system.h>
+#include <ilc/processing/module_interface.h>
+#include <ilc/processing/snapshot.h>
+#include <ilc/processing/target_setup.h>
+
+#define ILC_SNAPSHOT_MAGIC "ILCSNAP\0"
+
+#define ILC_SNAPSHOT_MAGIC_SIZE 8
+
+/**
+ * Bump whenever the layout or the contents of snapshots change, to
+ * invalidate existing snapshots.
+ */
+#define ILC_SNAPSHOT_SCHEMA_VERSION 2
+
+// Separates CPU features, which never contain it.
+#define ILC_SNAPSHOT_FEATURE_SEPARATOR ','
+
+namespace ilc {
+    namespace {
+        void writeString(std::ofstream &stream, const std::string &value) {
+            uint32_t length = value.length();
+
+            stream.write(reinterpret_cast<const char *>(&length), sizeof(length));
+            stream.write(value.data(), length);
+        }
+
+        /**
+         * Read a length-prefixed string at the given position, advancing
+         * it. Returns std::nullopt if the buffer is too short.
+         */
+        std::optional<std::string> readString(const llvm::MemoryBuffer &buffer, size_t &position) {
+            uint32_t length;
+
+            if (buffer.getBufferSize() - position < sizeof(length)) {
+                return std::nullopt;
+            }
+
+            std::memcpy(&length, buffer.getBufferStart() + position, sizeof(length));
+            position += sizeof(length);
+
+            if (buffer.getBufferSize() - position < length) {
+                return std::nullopt;
+            }
+
+            std::string result = std::string(buffer.getBufferStart() + position, length);
+
+            position += length;
+
+            return result;
+        }
+
+        /**
+         * Split the given string at every occurrence of the separator,
+         * which also terminates the last part.
+         */
+        std::vector<std::string> split(const std::string &value, char separator) {
+            std::vector<std::string> result = {};
+            size_t partStart = 0;
+
+            while (partStart < value.length()) {
+                size_t partEnd = std::min(value.find(separator, partStart), value.length());
+
+                result.push_back(value.substr(partStart, partEnd - partStart));
+                partStart = partEnd + 1;
+            }
+
+            return result;
+        }
+    }
+
+    std::optional<SnapshotData> &Snapshot::getActiveStorage() {
+        static std::optional<SnapshotData> active = std::nullopt;
+
+        return active;
+    }
+
+    std::optional<std::vector<PreludeFile>> Snapshot::readPrelude(const std::vector<std::string> &preludeFilePaths) {
+        std::vector<PreludeFile> result = {};
+
+        for (const auto &preludeFilePath : preludeFilePaths) {
+            std::optional<std::string> source = FileSystem::readFileContents(preludeFilePath);
+
+            if (!source.has_value()) {
+                return std::nullopt;
+            }
+
+            result.push_back(PreludeFile{preludeFilePath, *source});
+        }
+
+        return result;
+    }
+
+    std::string Snapshot::extractPrelude(const std::vector<PreludeFile> &preludeFiles) {
+        std::string result;
+
+        for (const auto &preludeFile : preludeFiles) {
+            result += ModuleInterface::extract(preludeFile.source);
+        }
+
+        return result;
+    }
+
+    std::optional<SnapshotData> Snapshot::create(const std::vector<std::string> &preludeFilePaths) {
+        std::optional<std::vector<PreludeFile>> preludeFiles = Snapshot::readPrelude(preludeFilePaths);
+
+        if (!preludeFiles.has_value()) {
+            return std::nullopt;
+        }
+
+        // The host is queried directly, as Snapshot::load() does, rather than through any active snapshot.
+        return SnapshotData{
+            llvm::sys::getDefaultTargetTriple(),
+            llvm::sys::getHostCPUName().str(),
+            TargetSetup::findHostCpuFeatures(),
+            Snapshot::extractPrelude(*preludeFiles),
+            *preludeFiles
+        };
+    }
+
+    bool Snapshot::write(const std::filesystem::path &snapshotFilePath, const SnapshotData &data) {
+        std::ofstream stream = std::ofstream(snapshotFilePath, std::ios::binary | std::ios::trunc);
+        uint32_t schemaVersion = ILC_SNAPSHOT_SCHEMA_VERSION;
+        std::string hostCpuFeatures;
+
+        for (const auto &feature : data.hostCpuFeatures) {
+            hostCpuFeatures += feature + ILC_SNAPSHOT_FEATURE_SEPARATOR;
+        }
+
+        stream.write(ILC_SNAPSHOT_MAGIC, ILC_SNAPSHOT_MAGIC_SIZE);
+        stream.write(reinterpret_cast<const char *>(&schemaVersion), sizeof(schemaVersion));
+        writeString(stream, LLVM_VERSION_STRING);
+        writeString(stream, data.hostTriple);
+        writeString(stream, data.hostCpuName);
+        writeString(stream, hostCpuFeatures);
+        writeString(stream, data.prelude);
+
+        uint32_t preludeFileCount = data.preludeFiles.size();
+
+        stream.write(reinterpret_cast<const char *>(&preludeFileCount), sizeof(preludeFileCount));
+
+        for (const auto &preludeFile : data.preludeFiles) {
+            writeString(stream, preludeFile.filePath);
+            writeString(stream, preludeFile.source);
+        }
+
+        return stream.good();
+    }
+
+    std::optional<SnapshotData> Snapshot::load(const std::filesystem::path &snapshotFilePath) {
+        llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> snapshotFile =
+            llvm::MemoryBuffer::getFile(snapshotFilePath.string(), -1, false);
+
+        const size_t headerSize = ILC_SNAPSHOT_MAGIC_SIZE + sizeof(uint32_t);
+
+        if (!snapshotFile || (*snapshotFile)->getBufferSize() < headerSize) {
+            return std::nullopt;
+        }
+
+        const llvm::MemoryBuffer &buffer = **snapshotFile;
+        uint32_t schemaVersion;
+
+        std::memcpy(&schemaVersion, buffer.getBufferStart() + ILC_SNAPSHOT_MAGIC_SIZE, sizeof(schemaVersion));
+
+        if (std::memcmp(buffer.getBufferStart(), ILC_SNAPSHOT_MAGIC, ILC_SNAPSHOT_MAGIC_SIZE) != 0
+            || schemaVersion != ILC_SNAPSHOT_SCHEMA_VERSION) {
+            return std::nullopt;
+        }
+
+        size_t position = headerSize;
+        std::optional<std::string> llvmVersion = readString(buffer, position);
+
+        // Feature names may differ between LLVM versions.
+        if (!llvmVersion.has_value() || *llvmVersion != LLVM_VERSION_STRING) {
+            return std::nullopt;
+        }
+
+        std::optional<std::string> hostTriple = readString(buffer, position);
+        std::optional<std::string> hostCpuName = readString(buffer, position);
+        std::optional<std::string> hostCpuFeatures = readString(buffer, position);
+        std::optional<std::string> prelude = readString(buffer, position);
+
+        if (!hostTriple.has_value() || !hostCpuName.has_value() || !hostCpuFeatures.has_value() || !prelude.has_value()) {
+            return std::nullopt;
+        }
+
+        SnapshotData result = SnapshotData{
+            *hostTriple,
+            *hostCpuName,
+            split(*hostCpuFeatures, ILC_SNAPSHOT_FEATURE_SEPARATOR),
+            *prelude,
+            {}
+        };
+
+        uint32_t preludeFileCount;
+
+        if (buffer.getBufferSize() - position < sizeof(preludeFileCount)) {
+            return std::nullopt;
+        }
+
+        std::memcpy(&preludeFileCount, buffer.getBufferStart() + position, sizeof(preludeFileCount));
+        position += sizeof(preludeFileCount);
+
+        for (uint32_t i = 0; i < preludeFileCount; i++) {
+            std::optional<std::string> preludeFilePath = readString(buffer, position);
+            std::optional<std::string> preludeSource = readString(buffer, position);
+
+            if (!preludeFilePath.has_value() || !preludeSource.has_value()) {
+                return std::nullopt;
+            }
+
+            result.preludeFiles.push_back(PreludeFile{*preludeFilePath, *preludeSource});
+        }
+
+        /**
+         * A snapshot copied from another machine would otherwise make
+         * code generation target that machine's CPU. Feature order is
+         * not significant.
+         */
+        std::vector<std::string> snapshotFeatures = result.hostCpuFeatures;
+        std::vector<std::string> hostFeatures = TargetSetup::findHostCpuFeatures();
+
+        std::sort(snapshotFeatures.begin(), snapshotFeatures.end());
+        std::sort(hostFeatures.begin(), hostFeatures.end());
+
+        if (result.hostTriple != llvm::sys::getDefaultTargetTriple()
+            || result.hostCpuName != llvm::sys::getHostCPUName()
+            || snapshotFeatures != hostFeatures) {
+            return std::nullopt;
+        }
+
+        return result;
+    }
+
+    void Snapshot::activate(SnapshotData data) {
+        Snapshot::getActiveStorage() = std::move(data);
+    }
+
+    const std::optional<SnapshotData> &Snapshot::getActive() {
+        return Snapshot::getActiveStorage();
+    }
+}
@@ -0,0 +1,427 @@
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/MC/SubtargetFeature.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/TargetRegistry.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/xxhash.h>
+#include <ilc/cli/options.h>
+#include <ilc/misc/log.h>
+#include <ilc/processing/snapshot.h>
+#include <ilc/processing/target_setup.h>
+
+// Registry key under which all backends are registered at once.
+#define ILC_TARGET_SETUP_ALL_TARGETS "*"
+
+namespace ilc {
+    namespace {
+        struct TargetInitializer {
+            void (*targetInfo)() = nullptr;
+
+            void (*target)() = nullptr;
+
+            void (*targetMc)() = nullptr;
+
+            void (*asmPrinter)() = nullptr;
+
+            void (*asmParser)() = nullptr;
+        };
+
+        /**
+         * Map the name of every backend LLVM was built with to its
+         * initialization functions.
+         */
+        std::map<std::string, TargetInitializer> createTargetInitializers() {
+            std::map<std::string, TargetInitializer> result = {};
+
+#define LLVM_TARGET(TargetName) \
+            result[#TargetName].targetInfo = LLVMInitialize##TargetName##TargetInfo; \
+            result[#TargetName].target = LLVMInitialize##TargetName##Target; \
+            result[#TargetName].targetMc = LLVMInitialize##TargetName##TargetMC;
+#include <llvm/Config/Targets.def>
+
+#define LLVM_ASM_PRINTER(TargetName) \
+            result[#TargetName].asmPrinter = LLVMInitialize##TargetName##AsmPrinter;
+#include <llvm/Config/AsmPrinters.def>
+
+#define LLVM_ASM_PARSER(TargetName) \
+            result[#TargetName].asmParser = LLVMInitialize##TargetName##AsmParser;
+#include <llvm/Config/AsmParsers.def>
+
+            return result;
+        }
+
+        /**
+         * Find the name of the backend responsible for the given triple,
+         * as used by LLVM's configuration files.
+         */
+        std::optional<std::string> findTargetName(const llvm::Triple &targetTriple) {
+            switch (targetTriple.getArch()) {
+                case llvm::Triple::x86:
+                case llvm::Triple::x86_64: {
+                    return "X86";
+                }
+
+                case llvm::Triple::aarch64:
+                case llvm::Triple::aarch64_be: {
+                    return "AArch64";
+                }
+
+                case llvm::Triple::arm:
+                case llvm::Triple::armeb:
+                case llvm::Triple::thumb:
+                case llvm::Triple::thumbeb: {
+                    return "ARM";
+                }
+
+                case llvm::Triple::riscv32:
+                case llvm::Triple::riscv64: {
+                    return "RISCV";
+                }
+
+                case llvm::Triple::ppc:
+                case llvm::Triple::ppc64:
+                case llvm::Triple::ppc64le: {
+                    return "PowerPC";
+                }
+
+                case llvm::Triple::mips:
+                case llvm::Triple::mipsel:
+                case llvm::Triple::mips64:
+                case llvm::Triple::mips64el: {
+                    return "Mips";
+                }
+
+                case llvm::Triple::systemz: {
+                    return "SystemZ";
+                }
+
+                case llvm::Triple::wasm32:
+                case llvm::Triple::wasm64: {
+                    return "WebAssembly";
+                }
+
+                default: {
+                    return std::nullopt;
+                }
+            }
+        }
+
+        /**
+         * Hash the contents of the profile at the given path, only reading
+         * it upon first use. Profiles are keyed by contents, since they
+         * are usually re-merged under the same name, but do not change
+         * during a single run.
+         */
+        std::string findProfileHash(const std::string &profilePath) {
+            static std::mutex profileHashesMutex;
+            static std::map<std::string, std::string> profileHashes = {};
+
+            std::lock_guard<std::mutex> lock(profileHashesMutex);
+            auto profileHash = profileHashes.find(profilePath);
+
+            if (profileHash != profileHashes.end()) {
+                return profileHash->second;
+            }
+
+            llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> profile = llvm::MemoryBuffer::getFile(profilePath);
+
+            std::string result = profile
+                ? llvm::utohexstr(llvm::xxHash64((*profile)->getBuffer()))
+                : std::string("unreadable");
+
+            profileHashes[profilePath] = result;
+
+            return result;
+        }
+
+        bool isHostArchitecture(const llvm::Triple &targetTriple) {
+            return llvm::Triple(llvm::sys::getProcessTriple()).getArch() == targetTriple.getArch();
+        }
+    }
+
+    void TargetSetup::initializeTarget(const llvm::Triple &targetTriple) {
+        static std::mutex initializationMutex;
+        static std::set<std::string> initializedTargetNames = {};
+        static const std::map<std::string, TargetInitializer> targetInitializers = createTargetInitializers();
+
+        /**
+         * The target registry is global and not safe to populate from
+         * multiple threads, yet drivers may run in parallel.
+         */
+        std::lock_guard<std::mutex> lock(initializationMutex);
+
+        std::optional<std::string> targetName = findTargetName(targetTriple);
+
+        // Unknown architectures fallback to registering every backend.
+        if (!targetName.has_value() || !targetInitializers.contains(*targetName)) {
+            targetName = ILC_TARGET_SETUP_ALL_TARGETS;
+        }
+
+        if (!initializedTargetNames.insert(*targetName).second) {
+            return;
+        }
+        else if (*targetName == ILC_TARGET_SETUP_ALL_TARGETS) {
+            llvm::InitializeAllTargetInfos();
+            llvm::InitializeAllTargets();
+            llvm::InitializeAllTargetMCs();
+            llvm::InitializeAllAsmParsers();
+            llvm::InitializeAllAsmPrinters();
+
+            return;
+        }
+
+        const TargetInitializer &targetInitializer = targetInitializers.at(*targetName);
+
+        targetInitializer.targetInfo();
+        targetInitializer.target();
+        targetInitializer.targetMc();
+
+        if (targetInitializer.asmPrinter != nullptr) {
+            targetInitializer.asmPrinter();
+        }
+
+        if (targetInitializer.asmParser != nullptr) {
+            targetInitializer.asmParser();
+        }
+    }
+
+    std::string TargetSetup::findCpuName(const llvm::Triple &targetTriple) {
+        // The host's CPU is meaningless when cross-compiling.
+        if (!isHostArchitecture(targetTriple)) {
+            return "generic";
+        }
+        else if (Snapshot::getActive().has_value()) {
+            return Snapshot::getActive()->hostCpuName;
+        }
+
+        return llvm::sys::getHostCPUName();
+    }
+
+    std::vector<std::string> TargetSetup::findCpuFeatures(const llvm::Triple &targetTriple) {
+        if (!isHostArchitecture(targetTriple)) {
+            return {};
+        }
+        else if (Snapshot::getActive().has_value()) {
+            return Snapshot::getActive()->hostCpuFeatures;
+        }
+
+        return TargetSetup::findHostCpuFeatures();
+    }
+
+    std::vector<std::string> TargetSetup::findHostCpuFeatures() {
+        llvm::SubtargetFeatures subtargetFeatures = llvm::SubtargetFeatures();
+        llvm::StringMap<bool> hostFeatures = llvm::StringMap<bool>();
+
+        if (llvm::sys::getHostCPUFeatures(hostFeatures)) {
+            for (auto &feature : hostFeatures) {
+                subtargetFeatures.AddFeature(feature.first(), feature.second);
+            }
+        }
+
+        return subtargetFeatures.getFeatures();
+    }
+
+    std::string TargetSetup::findCpuName(const llvm::Triple &targetTriple, const cli::Options &options) {
+        if (!options.multiversionFunctions.empty() && targetTriple.getArch() == llvm::Triple::x86_64) {
+            return "x86-64";
+        }
+
+        return TargetSetup::findCpuName(targetTriple);
+    }
+
+    std::vector<std::string> TargetSetup::findCpuFeatures(
+        const llvm::Triple &targetTriple,
+        const cli::Options &options
+    ) {
+        if (!options.multiversionFunctions.empty() && targetTriple.getArch() == llvm::Triple::x86_64) {
+            return {};
+        }
+
+        return TargetSetup::findCpuFeatures(targetTriple);
+    }
+
+    unsigned TargetSetup::findOptimizationLevel(const cli::Options &options) {
+        switch (options.optimizationLevel) {
+            case cli::OptimizationLevel::O0: {
+                return 0;
+            }
+
+            case cli::OptimizationLevel::O1: {
+                return 1;
+            }
+
+            case cli::OptimizationLevel::O3: {
+                return 3;
+            }
+
+            // Size optimization levels build upon the default level.
+            default: {
+                return 2;
+            }
+        }
+    }
+
+    unsigned TargetSetup::findSizeLevel(const cli::Options &options) {
+        switch (options.optimizationLevel) {
+            case cli::OptimizationLevel::Os: {
+                return 1;
+            }
+
+            case cli::OptimizationLevel::Oz: {
+                return 2;
+            }
+
+            default: {
+                return 0;
+            }
+        }
+    }
+
+    llvm::CodeGenOpt::Level TargetSetup::findCodeGenOptimizationLevel(const cli::Options &options) {
+        // Also selects the fast register allocator, and skips the costlier machine passes.
+        if (options.fastCodegen) {
+            return llvm::CodeGenOpt::None;
+        }
+
+        switch (options.optimizationLevel) {
+            case cli::OptimizationLevel::O0: {
+                return llvm::CodeGenOpt::None;
+            }
+
+            case cli::OptimizationLevel::O1: {
+                return llvm::CodeGenOpt::Less;
+            }
+
+            case cli::OptimizationLevel::O3: {
+                return llvm::CodeGenOpt::Aggressive;
+            }
+
+            // Size optimization levels use the default code generation level.
+            default: {
+                return llvm::CodeGenOpt::Default;
+            }
+        }
+    }
+
+    std::string TargetSetup::findConfigurationKey(
+        const llvm::Triple &targetTriple,
+        const cli::Options &options
+    ) {
+        std::string result = targetTriple.getTriple() + ";" + TargetSetup::findCpuName(targetTriple, options) + ";";
+
+        for (const auto &feature : TargetSetup::findCpuFeatures(targetTriple, options)) {
+            result += feature + ",";
+        }
+
+        result += ";MV";
+
+        for (const auto &functionName : options.multiversionFunctions) {
+            result += functionName + ",";
+        }
+
+        result += ";";
+
+        for (const auto &targetName : options.multiversionTargets) {
+            result += targetName + ",";
+        }
+
+        result += ";PG" + std::to_string((int)options.profileGenerate) + ";PU";
+
+        if (options.profileUse.has_value()) {
+            result += *options.profileUse + ":" + findProfileHash(*options.profileUse);
+        }
+
+        result += ";O" + std::to_string(TargetSetup::findOptimizationLevel(options))
+            + ";S" + std::to_string(TargetSetup::findSizeLevel(options))
+            + ";CG" + std::to_string((int)TargetSetup::findCodeGenOptimizationLevel(options))
+            + (options.fastCodegen ? ";fast" : "")
+            + (options.gcSections || options.icf ? ";sections" : "");
+
+        // Matches the relocation model chosen when creating the target machine.
+        if (options.emit.contains(cli::EmitKind::SharedObject)) {
+            result += ";pic";
+        }
+
+        return result;
+    }
+
+    std::unique_ptr<llvm::TargetMachine> TargetSetup::createTargetMachine(
+        const llvm::Triple &targetTriple,
+        const cli::Options &options
+    ) {
+        TargetSetup::initializeTarget(targetTriple);
+
+        std::string error;
+
+        const llvm::Target *target = llvm::TargetRegistry::lookupTarget(
+            targetTriple.getTriple(),
+            error
+        );
+
+        /**
+         * The requested target could not be found. This might occur if
+         * the target registry was not previously initialized, or if a
+         * bogus target triple was provided.
+         */
+        if (!target) {
+            log::error("Could not lookup target: " + error);
+
+            return nullptr;
+        }
+
+        llvm::SubtargetFeatures subtargetFeatures = llvm::SubtargetFeatures();
+
+        for (const auto &feature : TargetSetup::findCpuFeatures(targetTriple, options)) {
+            subtargetFeatures.AddFeature(feature);
+        }
+
+        llvm::TargetOptions targetOptions = llvm::TargetOptions();
+
+        /**
+         * GlobalISel is only mature enough for AArch64; functions it cannot
+         * select fall back to SelectionDAG silently. Other targets use
+         * FastISel, which itself falls back per instruction.
+         */
+        if (options.fastCodegen && targetTriple.getArch() == llvm::Triple::aarch64) {
+            targetOptions.EnableGlobalISel = true;
+            targetOptions.GlobalISelAbort = llvm::GlobalISelAbortMode::Disable;
+        }
+        else if (options.fastCodegen) {
+            targetOptions.EnableFastISel = true;
+        }
+
+        /**
+         * Give every function and global its own section, so that the
+         * linker may remove those unreachable from the entry point and
+         * exported symbols, or fold identical ones.
+         */
+        if (options.gcSections || options.icf) {
+            targetOptions.FunctionSections = true;
+            targetOptions.DataSections = true;
+        }
+
+        llvm::Optional<llvm::Reloc::Model> relocationModel =
+            llvm::Optional<llvm::Reloc::Model>();
+
+        // Shared objects require position-independent code.
+        if (options.emit.contains(cli::EmitKind::SharedObject)) {
+            relocationModel = llvm::Reloc::PIC_;
+        }
+
+        return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(
+            targetTriple.getTriple(),
+            TargetSetup::findCpuName(targetTriple, options),
+            subtargetFeatures.getString(),
+            targetOptions,
+            relocationModel,
+            llvm::None,
+            TargetSetup::findCodeGenOptimizationLevel(options)
+        ));
+    }
+}